@@ -0,0 +1,55 @@
+// cluster.h - Distributed Lazy SMP: one coordinator and several worker processes connected over TCP
+
+#pragma once
+#include "utils.h"
+#include "search.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+constexpr int CLUSTER_SHARE_DEPTH = 5;   // TT entries at least this deep are sent to the other workers
+constexpr int CLUSTER_FLUSH_MS = 20;     // interval at which a worker sends its shared entries
+constexpr size_t CLUSTER_OUTBOX = 4096;  // shared entries waiting for the flusher, the rest are dropped
+
+/**
+ * clusterListen - Coordinator: accepts worker connections on @port until @numWorkers are connected.
+ * Returns false if the port cannot be opened or workers are still connected (cluster quit first).
+ */
+bool clusterListen(int port, int numWorkers);
+
+/**
+ * clusterWorkers - Number of connected workers (0 = no cluster).
+ */
+size_t clusterWorkers();
+
+/**
+ * clusterShutdown - Tells the workers to quit and closes the connections.
+ */
+void clusterShutdown();
+
+/**
+ * clusterSearch - Coordinator: every worker runs its own search of @board and the workers
+ * exchange their deep transposition table entries through the coordinator. The search ends
+ * when the first worker finishes, the others are stopped then.
+ * @history: Keys of the game positions before @board, for repetition detection.
+ * @numWorkers: Workers taking part, the first ones connected (0 = all).
+ * Returns the result of the worker that completed the deepest iteration.
+ */
+SearchResult clusterSearch(const BoardState& board, const SearchLimits& limits,
+                           const std::vector<uint64_t>& history, size_t numWorkers = 0);
+
+/**
+ * clusterCompare - Searches @board with a single worker and then with all workers, both times
+ * from empty tables, and prints nodes per second and time to depth of both runs.
+ */
+void clusterCompare(const BoardState& board, const SearchLimits& limits);
+
+/**
+ * clusterWorker - Worker: connects to the coordinator at @host:@port and runs the searches it
+ * asks for until the coordinator quits or disconnects.
+ * @mode: Parallel search used inside the worker process.
+ * @numThreads: Search threads of the worker process.
+ * Returns false if the coordinator cannot be reached.
+ */
+bool clusterWorker(const std::string& host, int port, SearchMode mode, int numThreads);
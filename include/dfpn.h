@@ -0,0 +1,38 @@
+// dfpn.h - Depth-first proof-number search, a mate solver next to the alpha-beta search
+
+#pragma once
+#include "utils.h"
+#include "movegen.h"
+#include "threadPool.h"
+
+#include <cstdint>
+#include <vector>
+
+// Proof and disproof numbers at or above this value mean "solved"
+constexpr uint32_t DFPN_INF = 100000000;
+
+// Longest line the solver follows, deeper positions count as not mated
+constexpr int DFPN_MAX_PLY = 200;
+
+/**
+ * Outcome of a mate search for the side to move.
+ */
+struct MateResult {
+    bool proven = false;      // a forced mate was found
+    bool disproven = false;   // there is no forced mate (within DFPN_MAX_PLY plies)
+    int distance = 0;         // length of the found mating line in plies (not necessarily the shortest)
+    std::vector<Move> line;   // mating line, attacker's move first
+    uint64_t nodes = 0;       // positions expanded
+    int64_t timeMs = 0;       // time spent
+    size_t tableEntries = 0;  // proof table slots in use at the end
+};
+
+/**
+ * solveMate - Searches for a forced mate by the side to move with df-pn.
+ * @board: Root position.
+ * @maxNodes: Expansions after which the search gives up (0 = no limit).
+ * @hashMb: Memory for the proof tables, split between the threads.
+ * @numThreads: 1 runs df-pn on the root itself; more threads solve the root moves in parallel.
+ * @pool: Thread pool with at least numThreads workers.
+ */
+MateResult solveMate(const BoardState& board, uint64_t maxNodes, size_t hashMb, int numThreads, ThreadPool& pool);
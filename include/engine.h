@@ -15,4 +15,10 @@
  */
 std::string engine(std::string Command, std::string fenInput, BoardState& board);
 
+/**
+ * initEngineTables - Initializes the Zobrist keys and the attack tables, on the first call only.
+ * They are immutable afterwards and shared by every engine instance of the process.
+ */
+void initEngineTables();
+
 #endif // ENGINE_H
\ No newline at end of file
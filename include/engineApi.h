@@ -0,0 +1,94 @@
+// engineApi.h - Reentrant engine instances: each Engine owns its TT, search threads, options and game
+
+#pragma once
+#include "utils.h"
+#include "search.h"
+#include "searchController.h"
+#include "transposition.h"
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+constexpr size_t ENGINE_DEFAULT_HASH_MB = 64;  // TT size of a new instance
+
+/**
+ * @brief An independent chess engine for embedding, e.g. many analysis engines in one process.
+ * Every instance owns all of its mutable state: transposition table, search threads with
+ * their history tables, search options and game. Only the immutable Zobrist keys and attack
+ * tables are shared. Any number of instances may search at the same time, each one runs one
+ * search at a time. The methods of one instance must not be called concurrently.
+ */
+class Engine {
+public:
+    using Callback = SearchController::DoneCallback;
+
+    explicit Engine(size_t hashMb = ENGINE_DEFAULT_HASH_MB, int numThreads = 1, SearchMode mode = LAZY_SMP);
+    ~Engine();
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    /**
+     * setPosition - Sets the position to search: a FEN and the moves played from it.
+     * @moves: Long algebraic notation ("e2e4", "e7e8q"), they form the game history for
+     * repetition detection.
+     * Returns false and keeps the previous position if the FEN or a move is not valid.
+     */
+    bool setPosition(const std::string& fen, const std::vector<std::string>& moves = {});
+
+    /**
+     * search - Starts searching the position in the background, a running search is stopped first.
+     * @onDone: Optional, called on a search thread with the result when the search ends.
+     */
+    void search(const SearchLimits& limits, Callback onDone = nullptr);
+
+    /**
+     * stop - Asks the running search to stop, does not wait for it.
+     */
+    void stop();
+
+    /**
+     * wait - Blocks until the search has finished and returns its result.
+     */
+    SearchResult wait();
+
+    /**
+     * newGame - Clears the TT and the move ordering learnt in earlier searches.
+     */
+    void newGame();
+
+    void setThreads(int threads);
+    void setMode(SearchMode searchMode);
+
+    /**
+     * setHash - Replaces the TT by an empty one of @hashMb megabytes (1..TT_MAX_MB).
+     * Returns false and keeps the old table if the memory is not available.
+     */
+    bool setHash(size_t hashMb);
+
+    /**
+     * setInfoStream - Stream the search writes its "info" lines to (std::cout by default).
+     */
+    void setInfoStream(std::ostream& out);
+
+    // Selective search switches, only to be changed while no search runs
+    SearchOptions& options() { return context.options; }
+
+    // Nodes of the running or last search
+    uint64_t nodes() const { return context.nodes.load(); }
+
+    const BoardState& position() const { return root; }
+
+private:
+    std::unique_ptr<TranspositionTable> table;
+    SearchContext context;
+    SearchController controller;     // declared last, so its threads stop before the rest goes
+    BoardState root{};
+    std::vector<uint64_t> history;   // keys of the positions before root, oldest first
+    int numThreads;
+    SearchMode mode;
+
+    void finishSearch();
+};
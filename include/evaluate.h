@@ -4,7 +4,7 @@
 
 /**
  * Evaluates the board state and returns a score.
- * Positive scores favor White, negative scores favor Black.
+ * Positive scores favor the side to move. Static only: mates are left to the search.
  * @param board The current board state.
  * @return The evaluation score.
  */
@@ -0,0 +1,28 @@
+// mcts.h - Parallel Monte Carlo Tree Search with PUCT selection, an alternative to the alpha-beta search
+
+#pragma once
+#include "utils.h"
+#include "movegen.h"
+#include "search.h"
+#include "threadPool.h"
+
+#include <cstddef>
+
+constexpr float MCTS_CPUCT = 1.5f;          // exploration constant of the PUCT formula
+constexpr int MCTS_VIRTUAL_LOSS = 3;        // losses a thread adds to a node while its playout passes it
+constexpr int MCTS_VALUE_SCALE = 400;       // centipawns of a leaf score mapped to tanh(cp / scale)
+constexpr size_t MCTS_ARENA_MB = 256;       // memory of the node arena, the tree stops growing when it is full
+constexpr int MCTS_REPORT_MS = 500;         // interval of the "info" lines
+
+/**
+ * mctsSearch - Searches the root with Monte Carlo Tree Search: PUCT selection, leaf values from
+ * the quiescence search instead of random playouts, and all threads expanding one shared tree.
+ * @board: Root position.
+ * @maxDepth: The search stops once the most visited line is this long.
+ * @timeLimitMs: Soft time budget in milliseconds (0 = no limit).
+ * @numThreads: Number of playout threads (calling thread included).
+ * @pool: Thread pool with at least numThreads - 1 workers.
+ * Returns the most visited root move, its score in centipawns and the most visited line.
+ */
+SearchResult mctsSearch(const BoardState& board, int maxDepth, int timeLimitMs,
+                        int numThreads, ThreadPool& pool);
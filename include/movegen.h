@@ -49,6 +49,18 @@ struct MoveList {
  */
 void initAttackTables();
 
+/**
+ * Sliding piece attacks from `sq`, rays stop at the first piece in `blockers`.
+ */
+uint64_t bishopAttacks(int sq, uint64_t blockers);
+uint64_t rookAttacks(int sq, uint64_t blockers);
+
+/**
+ * Returns all pieces of both colors attacking `sq` given the occupancy `occupied`.
+ * Removing pieces from `occupied` uncovers x-ray attackers (used by the static exchange evaluation).
+ */
+uint64_t attackersTo(const BoardState& board, int sq, uint64_t occupied);
+
 /**
  * Generates all pseudo-legal moves for the side to move.
  * Also computes total attack masks for both sides.
@@ -56,18 +68,39 @@ void initAttackTables();
  */
 MoveList generateMoves(const BoardState& board);
 
+/**
+ * Same as above, into `result`. Reusing one list keeps its capacity, so no memory is allocated.
+ */
+void generateMoves(const BoardState& board, MoveList& result);
+
 /**
  * Converts a board index (0..63) to file and rank.
  * Example: squareToCoords(0) -> (a1), 63 -> (h8)
  */
 std::string squareToString(int sq);
 
+/**
+ * Converts a move to its coordinate string (from, to and optional promotion piece).
+ * Example: moveToString(e2->e4) -> "e2e4"
+ */
+std::string moveToString(const Move& move);
+
 /**
  * Function that ensures the king is not exposed to check after move generation.
  */
 bool isLegalMoveState(const BoardState& board);
 
+/**
+ * Returns true if the king of the side to move is attacked.
+ */
+bool isInCheck(const BoardState& board);
+
 /**
  * Generates all legal moves for the side to move, filtering out moves that leave the king in check.
  */
-MoveList generateLegalMoves(const BoardState& board);
\ No newline at end of file
+MoveList generateLegalMoves(const BoardState& board);
+
+/**
+ * Same as above, into `legal`. Reusing one list keeps its capacity, so no memory is allocated.
+ */
+void generateLegalMoves(const BoardState& board, MoveList& legal);
\ No newline at end of file
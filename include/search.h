@@ -4,12 +4,321 @@
 #include "utils.h"
 #include "movegen.h"
 #include "evaluate.h"
+#include "threadPool.h"
+#include "transposition.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Score bounds and aspiration window settings
+constexpr int INF_SCORE = 1000000;         // larger than any evaluation
+constexpr int ASPIRATION_WINDOW = 50;      // initial half-width of the aspiration window
+constexpr int ASPIRATION_MIN_DEPTH = 4;    // first iteration that uses an aspiration window
+constexpr int MAX_PLY = 128;               // deepest line the search follows
+constexpr int MATE_SCORE = 900000;         // score of mating at the root, a mate in n plies scores MATE_SCORE - n
+constexpr int MATE_BOUND = MATE_SCORE - MAX_PLY; // scores beyond +-MATE_BOUND are mates
+
+// Parallel search algorithms selectable in the engine
+enum SearchMode { ROOT_SPLIT, LAZY_SMP, YBWC, MCTS };
+
+/**
+ * One root move of a MultiPV search with its exact score and principal variation.
+ */
+struct RootLine {
+    Move move{};
+    int score = 0;
+    std::vector<Move> pv;
+};
+
+/**
+ * Result of the last completed iterative deepening iteration.
+ */
+struct SearchResult {
+    Move bestMove{};     // best root move
+    int score = 0;       // score of the best move, from the side to move's perspective
+    int depth = 0;       // depth of the completed iteration
+    bool found = false;  // false if the root position has no legal moves
+    std::vector<Move> pv; // principal variation, starts with bestMove; pv[1] is the expected reply
+    std::vector<RootLine> lines; // MultiPV only: the best root moves, best first
+};
+
+/**
+ * A line of moves, used to pass principal variations between threads.
+ */
+struct PvLine {
+    Move moves[MAX_PLY];
+    int length = 0;
+};
+
+/**
+ * Limits of one search. Zero means no limit.
+ */
+struct SearchLimits {
+    int maxDepth = MAX_PLY - 1;  // deepest iteration
+    int softTimeMs = 0;          // target time, see TimeManager for when a new iteration is started
+    int moveTimeMs = 0;          // hard limit, the search is stopped when it runs out
+    uint64_t maxNodes = 0;       // hard node limit, the search is stopped when it is reached
+    int multiPv = 1;             // number of best root moves to search exactly (MultiPV)
+    bool ponder = false;         // limits wait for ponderHit(), the time still counts from the start
+};
+
+
+/**
+ * Runtime switches of the selective search, changed with the engine command "set <name> <on|off>".
+ */
+struct SearchOptions {
+    bool nullMove = true;            // null move pruning ("nullmove")
+    bool lateMoveReductions = true;  // history-driven late move reductions ("lmr")
+    bool reverseFutility = true;     // reverse futility / static null move pruning ("rfp")
+    bool futility = true;            // futility pruning of quiet moves ("futility")
+    bool razoring = true;            // razoring into quiescence ("razoring")
+    bool lateMovePruning = true;     // late move pruning ("lmp")
+    bool checkExtensions = true;     // extend nodes in check ("checkext")
+    bool quiescenceChecks = false;   // quiet checks at the first quiescence ply ("qchecks")
+};
+
+// Split points of a context's YBWC searches (defined in ybwc.cpp)
+struct YbwcState;
+
+// Node memory of a context's MCTS searches (defined in mcts.cpp)
+class NodeArena;
+
+/**
+ * Mutable state of one engine instance's searches, shared by all of its search threads.
+ * Contexts are independent of each other, so several engines can search in one process.
+ * A thread searches for the context it is bound to (see bindSearchContext), and its
+ * thread-local tables (search stack, history) belong to that context as well.
+ * Zobrist keys and attack tables are immutable once initialized and shared by all.
+ */
+struct SearchContext {
+    TranspositionTable* tt = &TT;           // the global table unless the owner brings its own
+    std::atomic<uint64_t> nodes{0};         // nodes searched since prepareSearch (negamax + quiescence)
+    std::atomic<bool> stopped{false};       // aborts the running search (checked at every node)
+
+    // Hard limits of the running search, 0 = none (armed by prepareSearch)
+    std::atomic<uint64_t> nodeLimit{0};
+    std::atomic<int64_t> deadlineMs{0};     // steady clock time in milliseconds
+
+    // Pondering: the limits run from the start of the search but are only enforced after the ponderhit
+    std::atomic<bool> pondering{false};
+    std::atomic<bool> stopOnPonderhit{false};  // the time manager wanted to stop while pondering
+
+    SearchOptions options;
+    std::vector<uint64_t> gameHistory;      // keys of the game before the root, oldest first
+    std::vector<Move> expectedLine;         // line expected from the root, see setExpectedLine
+    std::ostream* info = &std::cout;        // "info" lines of the search reports
+    std::shared_ptr<YbwcState> ybwc;        // created by the first YBWC search
+    std::shared_ptr<NodeArena> mctsArena;   // created by the first MCTS search, reused by the next ones
+};
+
+/**
+ * defaultSearchContext - Context of the engine() command interface, with the global TT.
+ */
+SearchContext& defaultSearchContext();
+
+/**
+ * searchContext - Context the calling thread searches for, the default one if it was never bound.
+ */
+SearchContext& searchContext();
+
+/**
+ * bindSearchContext - Makes the calling thread search for @context (nullptr: the default one).
+ * Search threads are bound once when they start, see SearchController.
+ */
+void bindSearchContext(SearchContext* context);
 
 /**
- * minimax - Implements the Min-Max with alpha-beta pruning algorithm to evaluate the best move.
+ * negamax - Implements fail-soft negamax with principal variation search to evaluate the best move.
  * @board: Current state of the chess board.
  * @depth: Depth of the search tree.
- * @maximizingPlayer: True for the AI player, false for the opponent.
+ * @alpha: Alpha value for alpha-beta pruning.
+ * @beta: Beta value for alpha-beta pruning.
+ * @ply: Distance from the root.
+ * @allowNull: False right after a null move.
+ * Returns the score from the side to move's perspective.
+ */
+int negamax(BoardState& board, int depth, int alpha, int beta, int ply, bool allowNull);
+
+/**
+ * quiescence - Searches captures only until the position is quiet.
+ * @board: Current state of the chess board.
+ * @alpha: Alpha value for alpha-beta pruning.
+ * @beta: Beta value for alpha-beta pruning.
+ * @ply: Distance from the root.
+ * @depth: 0 from the full-width search, it counts down with each quiescence ply.
+ * Returns the fail-soft score from the side to move's perspective.
+ */
+int quiescence(BoardState& board, int alpha, int beta, int ply, int depth);
+
+/**
+ * prepareSearch - Resets the stop flag and the node counter and arms the hard limits of the next search.
+ * @context: Context of the search.
+ * @limits: Node limit and move time, both polled by the search threads every NODE_BATCH nodes.
+ * Must be called before the search threads start.
+ */
+void prepareSearch(SearchContext& context, const SearchLimits& limits);
+
+/**
+ * ponderHit - The opponent played the move a ponder search of @context expected: from now on
+ * the search obeys its limits. If the time manager already wanted to stop, it stops at once.
+ */
+void ponderHit(SearchContext& context);
+
+/**
+ * deferStopToPonderhit - Called by a search that wants to stop on its soft time limit.
+ * Returns true while pondering: the stop is then carried out by ponderHit().
+ */
+bool deferStopToPonderhit();
+
+// TT scores beyond +-TT_MATE_BOUND are mates, TT_SCORE_MAX - n mating in n plies from the node
+constexpr int TT_MATE_BOUND = TT_SCORE_MAX - MAX_PLY;
+
+/**
+ * scoreToTT - Score of a node at @ply as the TT stores it. Mate scores count plies from the
+ * root; the TT counts them from the node instead, so an entry stays correct wherever in the
+ * tree the position is found again. Everything is squeezed into the 16-bit score of the TT.
+ */
+inline int scoreToTT(int score, int ply) {
+    if (score >= MATE_BOUND) return std::min(TT_SCORE_MAX - (MATE_SCORE - score - ply), TT_SCORE_MAX);
+    if (score <= -MATE_BOUND) return std::max(-TT_SCORE_MAX + (MATE_SCORE + score - ply), -TT_SCORE_MAX);
+    return std::max(-TT_MATE_BOUND + 1, std::min(score, TT_MATE_BOUND - 1));
+}
+
+/**
+ * scoreFromTT - Score of a TT entry for a node at @ply, the reverse of scoreToTT.
+ */
+inline int scoreFromTT(int score, int ply) {
+    if (score >= TT_MATE_BOUND) return MATE_SCORE - (TT_SCORE_MAX - score) - ply;
+    if (score <= -TT_MATE_BOUND) return -MATE_SCORE + (TT_SCORE_MAX + score) + ply;
+    return score;
+}
+
+/**
+ * scoreToString - Score for the search output: "cp <n>" or "mate <moves>".
+ */
+std::string scoreToString(int score);
+
+/**
+ * pvToString - Moves of a line separated by spaces.
+ */
+std::string pvToString(const std::vector<Move>& pv);
+
+/**
+ * keyedRoot - Copy of @board with its Zobrist key computed. negamax and quiescence take the
+ * key from the board, updateGameState and applyMove keep it up to date move by move.
+ */
+BoardState keyedRoot(const BoardState& board);
+
+/**
+ * recordPlyMove - Notes the move the calling thread plays at the given ply.
+ * It is the context of the countermove and continuation history heuristics of the reply.
+ */
+void recordPlyMove(int ply, const BoardState& board, const Move& move);
+
+/**
+ * resetPlyMoves - Forgets the line context of the calling thread: the moves recorded by
+ * recordPlyMove and the previous principal variation it was following.
+ */
+void resetPlyMoves();
+
+/**
+ * updatePv - Makes @move the best move at @ply on the calling thread, followed by the
+ * principal variation its child at ply + 1 left behind.
+ */
+void updatePv(int ply, const Move& move);
+
+/**
+ * getPv - Copies the calling thread's principal variation from @ply on into @line.
+ */
+void getPv(int ply, PvLine& line);
+
+/**
+ * setPv - Replaces the calling thread's principal variation from @ply on with @line.
+ */
+void setPv(int ply, const PvLine& line);
+
+/**
+ * setGameHistory - Sets the keys of the game positions before the root, oldest first, in the
+ * calling thread's context. The search scores repetitions of them as draws.
+ * Must not be called while a search runs.
+ */
+void setGameHistory(const std::vector<uint64_t>& keys);
+
+/**
+ * setExpectedLine - Sets the line the game is expected to follow from the next root in the
+ * calling thread's context, e.g. the rest of the principal variation of the previous move.
+ * The first iteration searches it first. Empty for none. Must not be called while a search runs.
+ */
+void setExpectedLine(const std::vector<Move>& line);
+
+// Preallocated per-thread frames of the current line, one per ply (defined in search.cpp)
+struct SearchStack;
+
+/**
+ * searchStack - Search stack of the calling thread.
+ */
+const SearchStack* searchStack();
+
+/**
+ * loadSearchPath - Copies the position keys of the first @plies frames of another thread's
+ * stack (YBWC helpers joining a split point).
+ */
+void loadSearchPath(const SearchStack* from, int plies);
+
+/**
+ * flushNodes - Adds the nodes counted by the calling thread to its context's node count.
+ * Search threads call it before they finish so no nodes are lost from the count.
+ */
+void flushNodes();
+
+/**
+ * iterativeDeepening - Runs successively deeper searches of the root position.
+ * @board: Root position.
+ * @maxDepth: Deepest iteration to run.
+ * @timeLimitMs: Soft time budget in milliseconds (0 = no limit).
+ * @pool: Thread pool used for the root split.
+ * Returns the best move and score of the last completed iteration.
+ */
+SearchResult iterativeDeepening(const BoardState& board, int maxDepth, int timeLimitMs, ThreadPool& pool);
+
+/**
+ * lazySmpSearch - Parallel iterative deepening where all threads share only the transposition table.
+ * @board: Root position.
+ * @maxDepth: Deepest iteration of the main thread.
+ * @timeLimitMs: Soft time budget in milliseconds (0 = no limit).
+ * @numThreads: Total number of search threads (main thread included).
+ * @pool: Thread pool with at least numThreads - 1 workers for the helper threads.
+ * Returns the result of the main thread.
+ */
+SearchResult lazySmpSearch(const BoardState& board, int maxDepth, int timeLimitMs,
+                           int numThreads, ThreadPool& pool);
+
+/**
+ * ybwcSearch - Parallel iterative deepening with Young Brothers Wait Concept split points.
+ * @board: Root position.
+ * @maxDepth: Deepest iteration.
+ * @timeLimitMs: Soft time budget in milliseconds (0 = no limit).
+ * @numThreads: Total number of search threads (calling thread included).
+ * @pool: Thread pool with at least numThreads - 1 workers for the helper threads.
+ * Returns the result of the last completed iteration.
+ */
+SearchResult ybwcSearch(const BoardState& board, int maxDepth, int timeLimitMs,
+                        int numThreads, ThreadPool& pool);
+
+/**
+ * multiPvSearch - Iterative deepening that finds the best @numLines root moves with exact scores.
+ * @board: Root position.
+ * @maxDepth: Deepest iteration.
+ * @timeLimitMs: Soft time budget in milliseconds (0 = no limit).
+ * @numLines: Number of lines (MultiPV), at most the number of legal moves is returned.
+ * @numThreads: Total number of search threads, the others join as YBWC helpers.
+ * @pool: Thread pool with at least numThreads - 1 workers, runs the helpers.
+ * Returns the best line as the result, and all lines ranked by score in SearchResult::lines.
  */
-int minimax(BoardState& board, int depth, int alpha, int beta, bool isMaximizingPlayer);
\ No newline at end of file
+SearchResult multiPvSearch(const BoardState& board, int maxDepth, int timeLimitMs, int numLines,
+                           int numThreads, ThreadPool& pool);
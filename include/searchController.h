@@ -0,0 +1,81 @@
+// searchController.h - Runs the search on a dedicated thread so it can be stopped at any time
+
+#pragma once
+#include "utils.h"
+#include "search.h"
+#include "threadPool.h"
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+/**
+ * @brief Owns the search threads of a search context. Only one search runs at a time.
+ * start() returns immediately; stop() and the limits end the search within one node batch,
+ * and wait() returns the result of the last completed iteration.
+ * The threads outlive a search, so their history tables carry over to the next one.
+ */
+class SearchController {
+public:
+    // Called on the search thread with the result of a finished search
+    using DoneCallback = std::function<void(const SearchResult&)>;
+
+    explicit SearchController(SearchContext& context = defaultSearchContext()) : context(context) {}
+    SearchController(const SearchController&) = delete;
+    SearchController& operator=(const SearchController&) = delete;
+    ~SearchController();
+
+    /**
+     * start - Starts searching a position in the background, a running search is stopped first.
+     * @board: Root position, copied.
+     * @limits: Depth, time and node limits of the search.
+     * @mode: Parallel search algorithm.
+     * @numThreads: Total number of search threads.
+     * @onDone: Optional, called with the result before wait() returns it.
+     */
+    void start(const BoardState& board, const SearchLimits& limits, SearchMode mode, int numThreads,
+               DoneCallback onDone = nullptr);
+
+    /**
+     * stop - Asks the running search to stop, does not wait for it.
+     */
+    void stop();
+
+    /**
+     * ponderHit - Turns a running ponder search into a normal one, see ::ponderHit().
+     */
+    void ponderHit();
+
+    /**
+     * wait - Blocks until the search has finished.
+     * Returns its result (found is false if nothing was searched).
+     */
+    SearchResult wait();
+
+    /**
+     * isRunning - True while a started search has not finished yet.
+     */
+    bool isRunning() const { return running.load(); }
+
+    /**
+     * resetThreads - Stops the search and replaces the search threads by new ones,
+     * which start with empty history tables (new game).
+     */
+    void resetThreads();
+
+private:
+    SearchContext& context;
+    std::unique_ptr<ThreadPool> driver;  // single thread running the search itself
+    std::unique_ptr<ThreadPool> pool;    // helper threads of the parallel searches
+    int poolThreads = 0;
+    std::future<void> searchTask;
+    std::atomic<bool> running{false};
+
+    std::mutex resultMutex;            // guards result and finished
+    std::condition_variable searchDone;
+    SearchResult result;
+    bool finished = true;
+};
@@ -0,0 +1,26 @@
+// see.h - Static exchange evaluation
+
+#pragma once
+#include "utils.h"
+#include "movegen.h"
+
+// Piece values used by the exchange evaluation
+constexpr int SEE_PAWN   = 100;
+constexpr int SEE_KNIGHT = 320;
+constexpr int SEE_BISHOP = 330;
+constexpr int SEE_ROOK   = 500;
+constexpr int SEE_QUEEN  = 900;
+constexpr int SEE_KING   = 20000;
+
+/**
+ * Returns the value of the piece the move captures (a pawn for en passant, 0 for non-captures).
+ */
+int capturedValue(const BoardState& board, const Move& move);
+
+/**
+ * staticExchange - Material balance of the capture sequence started by `move` on its target square.
+ * Both sides keep recapturing with their least valuable attacker (x-ray attackers included)
+ * and may stop whenever continuing would lose material.
+ * Returns the expected gain for the side making the move, negative if the move loses material.
+ */
+int staticExchange(const BoardState& board, const Move& move);
@@ -1,3 +1,4 @@
+#pragma once
 #include <queue>
 #include <thread>
 #include <mutex>
@@ -9,12 +10,15 @@
 
 /**
  * @brief A simple thread pool implementation for managing a pool of worker threads.
+ * @threadInit: Optional, run once on every worker thread before it takes tasks.
  */
 class ThreadPool {
 public:
-    explicit ThreadPool(size_t numThreads) : stop(false) {
+    explicit ThreadPool(size_t numThreads, std::function<void()> threadInit = nullptr) : stop(false) {
         for (size_t i = 0; i < numThreads; ++i) {
-            workers.emplace_back([this]() {
+            workers.emplace_back([this, threadInit]() {
+                if (threadInit)
+                    threadInit();
                 while (true) {
                     std::function<void()> task;
                     {
@@ -0,0 +1,66 @@
+// timeManager.h - Turns the game clock into time limits for one search
+
+#pragma once
+#include "movegen.h"
+
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Game clock of both sides, in milliseconds. A side without remaining time has no clock.
+ */
+struct TimeControl {
+    int wtime = 0;         // white's remaining time
+    int btime = 0;         // black's remaining time
+    int winc = 0;          // white's increment per move
+    int binc = 0;          // black's increment per move
+    int movestogo = 0;     // moves until the next time control (0 = rest of the game)
+    int moveOverhead = 50; // reserved per move for communication and GUI lag
+};
+
+/**
+ * Time limits of one search.
+ */
+struct TimeBudget {
+    int softMs = 0;  // target time, scaled by the search's stability (see TimeManager)
+    int hardMs = 0;  // the search is stopped at this point, whatever it is doing
+};
+
+/**
+ * allocateTime - Splits the remaining time of the side to move over the moves left.
+ * @tc: Game clock.
+ * @whiteToMove: Side the search is for.
+ * Returns zero limits if the side to move has no clock.
+ */
+TimeBudget allocateTime(const TimeControl& tc, bool whiteToMove);
+
+/**
+ * @brief Decides after every iteration whether a new one is worth starting.
+ * The soft limit grows when the best move just changed or the score dropped, and shrinks
+ * while the best move stays the same; with a single legal move the search ends at once.
+ */
+class TimeManager {
+public:
+    /**
+     * @softMs: Soft limit of the search (0 = no limit, iterations run until the depth or hard limit).
+     * @numRootMoves: Number of legal root moves.
+     */
+    TimeManager(int softMs, size_t numRootMoves);
+
+    /**
+     * iterationDone - Records a completed iteration.
+     * @bestMove: Best root move of the iteration.
+     * @score: Its score.
+     * @elapsedMs: Time since the search started.
+     * Returns true if no new iteration should be started.
+     */
+    bool iterationDone(const Move& bestMove, int score, int64_t elapsedMs);
+
+private:
+    int softMs;
+    bool singleMove;
+    int iterations = 0;
+    int stableIterations = 0;  // iterations in a row with the same best move
+    Move previousBest{};
+    int previousScore = 0;
+};
@@ -1,57 +1,279 @@
 #pragma once
 #include <cstdint>
-#include <vector>
-#include <mutex>
+#include <climits>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <cctype>
 #include "movegen.h"
 
 // Bound types for transposition table entries
 enum BoundType { EXACT, LOWERBOUND, UPPERBOUND };
 
+// Depth of an empty slot, below any stored entry (quiescence stores depth 0 and -1)
+constexpr int TT_DEPTH_NONE = -128;
+
+// Entries per cluster, one cluster fills one 64-byte cache line
+constexpr int TT_CLUSTER_SIZE = 5;
+
+// Scores are stored in 16 bits, the search maps mates into this range
+constexpr int TT_SCORE_MAX = 32000;
+
+// Static evaluation of an entry stored without one (e.g. in check)
+constexpr int TT_EVAL_NONE = INT16_MIN;
+
+// Replacement: one search of age costs as much as this many plies of depth
+constexpr int TT_AGE_WEIGHT = 8;
+
+// Table memory is aligned to and requested in huge pages of this size
+constexpr size_t TT_HUGE_PAGE = 2 * 1024 * 1024;
+
+// Largest hash size accepted by resize, in MB
+constexpr size_t TT_MAX_MB = 128 * 1024;
+
+// Each clearing thread gets at least this much of the table
+constexpr size_t TT_CLEAR_CHUNK = 16 * 1024 * 1024;
+
 // Transposition Table Entry
 struct TTEntry {
     uint64_t key = 0;       // Zobrist hash key
-    int depth = 0;          // Search depth
-    int score = 0;          // Evaluation score
+    int depth = TT_DEPTH_NONE; // Search depth
+    int score = 0;          // Evaluation score, within +-TT_SCORE_MAX
     BoundType flag = EXACT; // Bound type
-    Move bestMove;          // Best move found
+    Move bestMove{};        // Best move found, the table keeps only from, to and promotion
+    int eval = TT_EVAL_NONE; // Static evaluation of the position
+    uint8_t generation = 0; // search that stored the entry, set by the table
+};
+
+// Entry packed into one word: key fragment 16 | move 16 | score 16 | depth 8 | bound 2 + generation 6.
+// The key fragment is the low 16 bits of the key, the cluster index comes from the high bits.
+// An all-zero word decodes as empty (depth TT_DEPTH_NONE).
+// The static evaluation has a word of its own: eval 16 | key bits 16..31.
+namespace ttpack {
+    constexpr int MOVE_SHIFT = 16;
+    constexpr int SCORE_SHIFT = 32;
+    constexpr int DEPTH_SHIFT = 48;    // depth - TT_DEPTH_NONE
+    constexpr int FLAG_SHIFT = 56;
+    constexpr int GEN_SHIFT = 58;
+    constexpr uint8_t GEN_MASK = 63;
+    constexpr char PROMOTIONS[] = {'\0', 'Q', 'R', 'B', 'N'};
+
+    // from 6 | to 6 | promotion 3, black promotions are told apart by the target rank
+    inline uint64_t packMove(const Move& m) {
+        uint64_t promo = 0;
+        for (uint64_t i = 1; i < sizeof(PROMOTIONS); ++i)
+            if (PROMOTIONS[i] == std::toupper(static_cast<unsigned char>(m.promotion))) promo = i;
+        return uint64_t(m.from & 63) | uint64_t(m.to & 63) << 6 | promo << 12;
+    }
+
+    inline Move unpackMove(uint64_t bits) {
+        Move m{};
+        m.from = int(bits & 63);
+        m.to = int((bits >> 6) & 63);
+        char promo = PROMOTIONS[std::min<uint64_t>((bits >> 12) & 7, sizeof(PROMOTIONS) - 1)];
+        m.promotion = (promo && m.to < 56) ? char(std::tolower(promo)) : promo;
+        return m;
+    }
+
+    inline uint64_t pack(const TTEntry& e, uint8_t generation) {
+        int score = std::max(-TT_SCORE_MAX, std::min(e.score, TT_SCORE_MAX));
+        return  (e.key & 0xFFFF)
+             | packMove(e.bestMove) << MOVE_SHIFT
+             | uint64_t(uint16_t(int16_t(score))) << SCORE_SHIFT
+             | uint64_t(std::min(e.depth, 127) - TT_DEPTH_NONE) << DEPTH_SHIFT
+             | uint64_t(e.flag) << FLAG_SHIFT
+             | uint64_t(generation & GEN_MASK) << GEN_SHIFT;
+    }
+
+    inline uint32_t packEval(uint64_t key, int eval) {
+        int16_t value = eval == TT_EVAL_NONE ? int16_t(TT_EVAL_NONE)
+                                             : int16_t(std::max(-INT16_MAX, std::min(eval, int(INT16_MAX))));
+        return uint32_t(uint16_t(value)) | uint32_t((key >> 16) & 0xFFFF) << 16;
+    }
+
+    // TT_EVAL_NONE unless the word was stored for key
+    inline int unpackEval(uint64_t key, uint32_t bits) {
+        if ((bits >> 16) != ((key >> 16) & 0xFFFF))
+            return TT_EVAL_NONE;
+        return int16_t(uint16_t(bits));
+    }
+
+    inline bool matches(uint64_t data, uint64_t key) {
+        return (data & 0xFFFF) == (key & 0xFFFF);
+    }
+
+    inline int depth(uint64_t data) {
+        return int((data >> DEPTH_SHIFT) & 0xFF) + TT_DEPTH_NONE;
+    }
+
+    inline uint8_t generation(uint64_t data) {
+        return uint8_t(data >> GEN_SHIFT) & GEN_MASK;
+    }
+
+    inline TTEntry unpack(uint64_t key, uint64_t data, uint32_t eval) {
+        TTEntry e;
+        e.key = key;
+        e.bestMove = unpackMove(data >> MOVE_SHIFT);
+        e.score = int16_t(uint16_t(data >> SCORE_SHIFT));
+        e.depth = depth(data);
+        e.flag = BoundType((data >> FLAG_SHIFT) & 3);
+        e.eval = unpackEval(key, eval);
+        e.generation = generation(data);
+        return e;
+    }
+}
+
+// A key maps to one cluster, its entry may sit in any slot of it.
+// Aligned so a probe touches a single cache line.
+// Each entry is one atomic word, written and read whole, so a thread never sees half of
+// another thread's entry. The static evaluation is a second word that a racing write may
+// pair with another entry, so it carries key bits of its own and is checked separately:
+// it is only returned for the position it was stored for, where any write has the same value.
+struct alignas(64) TTCluster {
+    std::atomic<uint64_t> data[TT_CLUSTER_SIZE];
+    std::atomic<uint32_t> eval[TT_CLUSTER_SIZE];
 };
+static_assert(sizeof(TTCluster) == 64, "a TT cluster must fill exactly one cache line");
 
-// Transposition Table
+// Transposition Table, lock-free: every thread reads and writes the slots directly.
+// The memory is mapped in huge pages where the system allows it and starts out zeroed,
+// so a new table is ready without touching it; pages are placed where they are first written.
 class TranspositionTable {
 public:
-    std::vector<TTEntry> table;  // Storage for transposition table entries
-    size_t size;                 // Number of entries in the table
+    size_t size = 0;              // Number of entries in the table
 
-    // Constructor
-    TranspositionTable(size_t mb = 64) {
-        size = (mb * 1024 * 1024) / sizeof(TTEntry);
-        if (size == 0) size = 1;
-        table.resize(size);
+    // Constructor, throws std::bad_alloc if the memory cannot be mapped
+    explicit TranspositionTable(size_t mb = 64);
+    ~TranspositionTable();
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Replace the table by an empty one of mb megabytes (1..TT_MAX_MB), cleared by numThreads
+    // threads (0 = one per core). Returns false and keeps the old table if the memory cannot be mapped.
+    // Must not be called while a search runs.
+    bool resize(size_t mb, int numThreads = 0);
+
+    // Size in megabytes
+    size_t sizeMb() const {
+        return clusterCount * sizeof(TTCluster) / (1024 * 1024);
+    }
+
+    // True if the system accepted the huge page request for the table
+    bool hugePages() const {
+        return huge;
     }
 
     // Store an entry in the transposition table (thread-safe)
     void store(const TTEntry& entry) {
-        size_t index = entry.key % size;
-        std::lock_guard<std::mutex> lock(mtx);
-        // simple replacement: prefer deeper entries
-        if (table[index].depth <= entry.depth) {
-            table[index] = entry;
-        }
+        if (insert(entry) && shareHook && entry.depth >= shareDepth)
+            shareHook(entry);
+    }
+
+    // Store an entry received from another process, it is not shared again
+    void import(const TTEntry& entry) {
+        insert(entry);
+    }
+
+    // Hands every stored entry at least minDepth deep to hook (cluster search), nullptr turns it off.
+    // Must not be called while a search runs.
+    void setShareHook(int minDepth, std::function<void(const TTEntry&)> hook) {
+        shareDepth = minDepth;
+        shareHook = std::move(hook);
     }
 
     // Probe the transposition table for an entry (thread-safe)
-    bool probe(uint64_t key, TTEntry& out) {
-        size_t index = key % size;
-        std::lock_guard<std::mutex> lock(mtx);
-        if (table[index].key == key && table[index].depth > 0) {
-            out = table[index];
-            return true;
+    bool probe(uint64_t key, TTEntry& out) const {
+        const TTCluster& cluster = clusterOf(key);
+        for (int i = 0; i < TT_CLUSTER_SIZE; ++i) {
+            uint64_t data = cluster.data[i].load(std::memory_order_relaxed);
+            if (ttpack::matches(data, key) && ttpack::depth(data) != TT_DEPTH_NONE) {
+                out = ttpack::unpack(key, data, cluster.eval[i].load(std::memory_order_relaxed));
+                return true;
+            }
         }
         return false;
     }
 
+    // Start loading the cluster of key into the cache, issued as soon as a child's key is known
+    // so the memory access overlaps the work done before the child probes
+    void prefetch(uint64_t key) const {
+        __builtin_prefetch(&clusterOf(key));
+    }
+
+    // Starts a new search: entries of earlier searches stay usable but give way to new ones (aging).
+    // Must not be called while a search runs.
+    void newSearch() {
+        generation = (generation + 1) & ttpack::GEN_MASK;
+    }
+
+    // Reset every entry, used between independent searches (e.g. bench positions).
+    // numThreads threads (0 = one per core) each zero one contiguous part, so on a NUMA machine
+    // the pages of a fresh table spread over the nodes of the threads that first write them.
+    // Must not be called while a search runs.
+    void clear(int numThreads = 0);
+
 private:
-    std::mutex mtx;
+    TTCluster* table = nullptr;   // Storage for transposition table entries
+    size_t clusterCount = 0;
+    size_t mappedBytes = 0;
+    bool huge = false;
+    uint8_t generation = 0;
+    int shareDepth = 0;
+    std::function<void(const TTEntry&)> shareHook;
+
+    // Multiply-shift maps the key onto the clusters, any table size works without a modulo
+    const TTCluster& clusterOf(uint64_t key) const {
+        return table[size_t((unsigned __int128)key * clusterCount >> 64)];
+    }
+
+    TTCluster& clusterOf(uint64_t key) {
+        return table[size_t((unsigned __int128)key * clusterCount >> 64)];
+    }
+
+    // Lower is replaced first: empty slots, then shallow entries and entries left from earlier searches
+    int replaceScore(uint64_t data) const {
+        if (ttpack::depth(data) == TT_DEPTH_NONE)
+            return INT_MIN;
+        int age = uint8_t(generation - ttpack::generation(data)) & ttpack::GEN_MASK;
+        return ttpack::depth(data) - TT_AGE_WEIGHT * age;
+    }
+
+    // Returns true if the entry was written
+    bool insert(const TTEntry& entry) {
+        TTCluster& cluster = clusterOf(entry.key);
+        int victim = 0;
+        int victimScore = INT_MAX;
+
+        for (int i = 0; i < TT_CLUSTER_SIZE; ++i) {
+            uint64_t old = cluster.data[i].load(std::memory_order_relaxed);
+
+            // Same position: a shallower bound of the current search does not replace it
+            if (ttpack::matches(old, entry.key) && ttpack::depth(old) != TT_DEPTH_NONE) {
+                if (entry.depth < ttpack::depth(old) && entry.flag != EXACT &&
+                    ttpack::generation(old) == generation)
+                    return false;
+                TTEntry updated = entry;
+                if (updated.bestMove.from == updated.bestMove.to)
+                    updated.bestMove = ttpack::unpackMove(old >> ttpack::MOVE_SHIFT); // keep the known move
+                write(cluster, i, updated);
+                return true;
+            }
+
+            int score = replaceScore(old);
+            if (score < victimScore) {
+                victim = i;
+                victimScore = score;
+            }
+        }
+
+        write(cluster, victim, entry);
+        return true;
+    }
+
+    void write(TTCluster& cluster, int i, const TTEntry& entry) {
+        cluster.eval[i].store(ttpack::packEval(entry.key, entry.eval), std::memory_order_relaxed);
+        cluster.data[i].store(ttpack::pack(entry, generation), std::memory_order_relaxed);
+    }
 };
 
 // Declare extern so other translation units can reference the global TT
@@ -0,0 +1,51 @@
+// ybwc.h - Young Brothers Wait Concept parallel search with work-stealing split points
+
+#pragma once
+#include "utils.h"
+#include "movegen.h"
+#include "threadPool.h"
+
+#include <vector>
+
+// Nodes with less remaining depth are always searched by a single thread
+constexpr int YBWC_MIN_SPLIT_DEPTH = 3;
+
+/**
+ * ybwcStartHelpers - Starts the helper threads that steal work from open split points.
+ * @numHelpers: Number of helpers, the searching thread itself is not included.
+ * @pool: Thread pool with at least numHelpers free workers.
+ */
+void ybwcStartHelpers(int numHelpers, ThreadPool& pool);
+
+/**
+ * ybwcStopHelpers - Stops the helper threads and waits until they have left the search.
+ */
+void ybwcStopHelpers();
+
+/**
+ * ybwcCanSplit - True if a node of the given depth should offer its remaining moves to idle helpers.
+ */
+bool ybwcCanSplit(int depth);
+
+/**
+ * ybwcAborted - True if a split point the calling thread is working under has failed high.
+ * The search below such a split point is useless and must not be stored.
+ */
+bool ybwcAborted();
+
+/**
+ * ybwcSplit - Searches the younger brothers moves[first..] of a node together with idle helpers.
+ * @board: Position of the node.
+ * @moves: Legal moves of the node, the eldest brother(s) before @first are already searched.
+ * @first: Index of the first move that is not searched yet.
+ * @depth: Remaining depth of the node.
+ * @ply: Distance of the node from the root.
+ * @alpha: Alpha of the node, raised by the brothers.
+ * @beta: Beta of the node.
+ * @bestScore: Best score so far, updated with the brothers' results.
+ * @bestMove: Best move so far, updated with the brothers' results.
+ * Returns once every helper has left the split point, with the principal variation of
+ * @bestMove in the calling thread's PV table at @ply.
+ */
+void ybwcSplit(const BoardState& board, const std::vector<Move>& moves, size_t first,
+               int depth, int ply, int& alpha, int beta, int& bestScore, Move& bestMove);
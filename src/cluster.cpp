@@ -0,0 +1,632 @@
+// cluster.cpp - Distributed Lazy SMP over TCP. Every worker process runs the normal search of the
+// same position; entries a worker stores at CLUSTER_SHARE_DEPTH or deeper are batched and sent to
+// the coordinator, which relays them to the other workers. The protocol is line based text:
+//
+//   coordinator -> worker:  search <maxDepth> <softMs> <hardMs> <maxNodes> <fen>
+//                           history <n> <key>...    stop    clear    quit
+//                           tt <key> <depth> <score> <flag> <from> <to> <promotion> <capture> <ep> <castling>
+//   worker -> coordinator:  hello <threads>
+//                           tt ...                  (same format)
+//                           out <line>              (everything the worker prints, "info depth" lines included)
+//                           done <depth> <score> <nodes> <pv...>
+
+#include "cluster.h"
+#include "engine.h"
+#include "movegen.h"
+#include "parsing.h"
+#include "searchController.h"
+#include "transposition.h"
+#include "updateBoard.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <thread>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+// ============================================================================
+//  SECTION 1: CONNECTIONS AND MESSAGES
+// ============================================================================
+
+/**
+ * @brief A TCP connection carrying newline-terminated messages.
+ * Any thread may send, a single thread reads.
+ */
+class Connection {
+public:
+    explicit Connection(int fd) : fd(fd) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    ~Connection() { ::close(fd); }
+
+    bool sendLine(const std::string& line) { return sendRaw(line + "\n"); }
+
+    bool sendRaw(const std::string& data) {
+        std::lock_guard<std::mutex> guard(writeMutex);
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0)
+                return false;
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    bool readLine(std::string& line) {
+        while (true) {
+            size_t end = buffer.find('\n', readPos);
+            if (end != std::string::npos) {
+                line.assign(buffer, readPos, end - readPos);
+                readPos = end + 1;
+                return true;
+            }
+            buffer.erase(0, readPos);
+            readPos = 0;
+
+            char chunk[16384];
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0)
+                return false;
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+    }
+
+    // Wakes up a thread blocked in readLine, which then returns false
+    void shutdown() { ::shutdown(fd, SHUT_RDWR); }
+
+private:
+    int fd;
+    std::mutex writeMutex;
+    std::string buffer;
+    size_t readPos = 0;
+};
+
+static std::string entryToLine(const TTEntry& e) {
+    std::ostringstream out;
+    out << "tt " << e.key << ' ' << e.depth << ' ' << e.score << ' ' << static_cast<int>(e.flag) << ' '
+        << e.bestMove.from << ' ' << e.bestMove.to << ' ' << static_cast<int>(e.bestMove.promotion) << ' '
+        << e.bestMove.isCapture << ' ' << e.bestMove.isEnPassant << ' ' << e.bestMove.isCastling << '\n';
+    return out.str();
+}
+
+// Reads the fields after "tt", returns false on a malformed message
+static bool lineToEntry(std::istringstream& iss, TTEntry& e) {
+    int flag, promotion, capture, enPassant, castling;
+    if (!(iss >> e.key >> e.depth >> e.score >> flag >> e.bestMove.from >> e.bestMove.to
+              >> promotion >> capture >> enPassant >> castling))
+        return false;
+    e.flag = static_cast<BoundType>(flag);
+    e.bestMove.promotion = static_cast<char>(promotion);
+    e.bestMove.isCapture = capture;
+    e.bestMove.isEnPassant = enPassant;
+    e.bestMove.isCastling = castling;
+    return true;
+}
+
+// Replays the moves in @iss from @board, stops at the first one that is not legal
+static std::vector<Move> readLineOfMoves(const BoardState& board, std::istringstream& iss) {
+    std::vector<Move> line;
+    BoardState current = board;
+    std::string text;
+    while (iss >> text) {
+        MoveList legal = generateLegalMoves(current);
+        auto it = std::find_if(legal.moves.begin(), legal.moves.end(),
+                               [&](const Move& m) { return moveToString(m) == text; });
+        if (it == legal.moves.end())
+            break;
+        line.push_back(*it);
+        updateGameState(current, *it);
+        applyMove(current, *it);
+    }
+    return line;
+}
+
+static int64_t elapsedSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+
+// ============================================================================
+//  SECTION 2: WORKER
+// ============================================================================
+
+/**
+ * @brief Stream buffer that prints as usual and also sends every completed line to the coordinator.
+ */
+class LineForwarder : public std::streambuf {
+public:
+    LineForwarder(Connection& conn, std::streambuf* echo) : conn(conn), echo(echo) {}
+
+protected:
+    int overflow(int c) override {
+        if (c == traits_type::eof())
+            return traits_type::not_eof(c);
+        std::lock_guard<std::mutex> guard(lineMutex);
+        put(static_cast<char>(c));
+        return c;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        std::lock_guard<std::mutex> guard(lineMutex);
+        for (std::streamsize i = 0; i < n; ++i)
+            put(s[i]);
+        return n;
+    }
+
+    int sync() override { return echo->pubsync(); }
+
+private:
+    Connection& conn;
+    std::streambuf* echo;
+    std::mutex lineMutex;
+    std::string line;
+
+    void put(char c) {
+        echo->sputc(c);
+        if (c == '\n') {
+            conn.sendLine("out " + line);
+            line.clear();
+        } else {
+            line += c;
+        }
+    }
+};
+
+/**
+ * @brief Bounded queue of the entries a worker shares. The search threads push without locking,
+ * an entry that finds the ring full is dropped. A single consumer at a time pops.
+ */
+class ShareRing {
+public:
+    ShareRing() : slots(new Slot[CLUSTER_OUTBOX]) {
+        for (size_t i = 0; i < CLUSTER_OUTBOX; ++i)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    void push(const TTEntry& e) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &slots[pos % CLUSTER_OUTBOX];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            if (sequence == pos) {
+                // Free slot, claim it
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (sequence < pos) {
+                return; // full
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+        slot->entry = e;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    bool pop(TTEntry& e) {
+        Slot& slot = slots[head % CLUSTER_OUTBOX];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+            return false;
+        e = slot.entry;
+        slot.sequence.store(head + CLUSTER_OUTBOX, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+private:
+    // sequence == position: free for the push at position, position + 1: filled
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        TTEntry entry;
+    };
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) size_t head = 0;
+};
+
+bool clusterWorker(const std::string& host, int port, SearchMode mode, int numThreads) {
+    addrinfo hints{}, *address = nullptr;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &address) != 0)
+        return false;
+
+    int fd = -1;
+    for (addrinfo* a = address; a != nullptr && fd < 0; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd >= 0 && connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(address);
+    if (fd < 0)
+        return false;
+
+    Connection conn(fd);
+    initEngineTables();
+
+    // Deep entries stored by the search, sent in batches by the flusher and after each search
+    ShareRing outbox;
+    std::mutex flushMutex;
+    auto flushOutbox = [&]() {
+        std::lock_guard<std::mutex> guard(flushMutex);
+        std::string data;
+        TTEntry e;
+        while (outbox.pop(e))
+            data += entryToLine(e);
+        if (!data.empty())
+            conn.sendRaw(data);
+    };
+    TT.setShareHook(CLUSTER_SHARE_DEPTH, [&outbox](const TTEntry& e) { outbox.push(e); });
+
+    std::atomic<bool> connected{true};
+    std::thread flusher([&]() {
+        while (connected.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(CLUSTER_FLUSH_MS));
+            flushOutbox();
+        }
+    });
+
+    // The coordinator reads the completed iterations from the search output
+    LineForwarder forwarder(conn, std::cout.rdbuf());
+    std::streambuf* console = std::cout.rdbuf(&forwarder);
+
+    SearchController controller;
+    std::thread waiter;
+    std::vector<uint64_t> history;
+    auto finishSearch = [&]() {
+        controller.stop();
+        if (waiter.joinable())
+            waiter.join();
+    };
+
+    conn.sendLine("hello " + std::to_string(numThreads));
+
+    std::string message;
+    while (conn.readLine(message)) {
+        std::istringstream iss(message);
+        std::string command;
+        iss >> command;
+
+        if (command == "tt") {
+            TTEntry e;
+            if (lineToEntry(iss, e))
+                TT.import(e);
+
+        } else if (command == "search") {
+            finishSearch();
+            SearchLimits limits;
+            iss >> limits.maxDepth >> limits.softTimeMs >> limits.moveTimeMs >> limits.maxNodes;
+            std::string fen;
+            std::getline(iss >> std::ws, fen);
+            BoardState board = parseFEN(fen);
+
+            setGameHistory(history);
+            controller.start(board, limits, mode, numThreads);
+            waiter = std::thread([&controller, &conn, &flushOutbox]() {
+                SearchResult result = controller.wait();
+                flushOutbox();
+
+                std::string done = "done " + std::to_string(result.depth) + " " + std::to_string(result.score) +
+                                   " " + std::to_string(defaultSearchContext().nodes.load());
+                for (const Move& m : result.pv)
+                    done += " " + moveToString(m);
+                if (result.found && result.pv.empty())
+                    done += " " + moveToString(result.bestMove);
+                conn.sendLine(done);
+            });
+
+        } else if (command == "history") {
+            size_t count = 0;
+            iss >> count;
+            history.assign(count, 0);
+            for (uint64_t& key : history)
+                iss >> key;
+
+        } else if (command == "stop") {
+            controller.stop();
+
+        } else if (command == "clear") {
+            finishSearch();
+            TT.clear();
+
+        } else if (command == "quit") {
+            break;
+        }
+    }
+
+    finishSearch();
+    connected = false;
+    flusher.join();
+    std::cout.rdbuf(console);
+    TT.setShareHook(0, nullptr);
+    return true;
+}
+
+
+// ============================================================================
+//  SECTION 3: COORDINATOR
+// ============================================================================
+
+/**
+ * A connected worker process and what it reported in the current search.
+ */
+struct WorkerLink {
+    std::unique_ptr<Connection> conn;
+    std::thread reader;
+    int threads = 0;
+    uint64_t nodes = 0;       // node count of its last report
+    bool done = true;         // finished the current search (or disconnected)
+    std::string doneMessage;  // fields of its "done" message
+};
+
+/**
+ * Time and cluster-wide node count when the first worker completed an iteration.
+ */
+struct DepthMark {
+    int depth;
+    int64_t timeMs;
+    uint64_t nodes;
+};
+
+/**
+ * Outcome of one cluster search, for the reports.
+ */
+struct ClusterRun {
+    SearchResult result;
+    uint64_t nodes = 0;
+    int64_t timeMs = 0;
+    std::vector<DepthMark> marks;
+};
+
+static std::vector<std::unique_ptr<WorkerLink>> workers;
+static std::mutex clusterMutex;              // guards the search state of the workers and the marks
+static std::condition_variable workerDone;
+static std::atomic<size_t> participants{0}; // workers[0..participants) take part in the current search
+static std::chrono::steady_clock::time_point searchStart;
+static std::vector<DepthMark> depthMarks;
+
+// Total node count of the participating workers, clusterMutex must be held
+static uint64_t clusterNodes() {
+    uint64_t total = 0;
+    for (size_t i = 0; i < participants.load(); ++i)
+        total += workers[i]->nodes;
+    return total;
+}
+
+/**
+ * readerLoop - Handles the messages of one worker: relays its entries to the other participants
+ * and records its progress.
+ */
+static void readerLoop(size_t index) {
+    WorkerLink& self = *workers[index];
+    std::string message;
+
+    while (self.conn->readLine(message)) {
+        std::istringstream iss(message);
+        std::string command;
+        iss >> command;
+
+        if (command == "tt") {
+            for (size_t i = 0; i < participants.load(); ++i)
+                if (i != index)
+                    workers[i]->conn->sendLine(message);
+
+        } else if (command == "out") {
+            std::string word;
+            int depth = -1;
+            uint64_t nodes = 0;
+            bool isInfo = (iss >> word) && word == "info";
+            while (isInfo && iss >> word) {
+                if (word == "depth") iss >> depth;
+                else if (word == "nodes") iss >> nodes;
+            }
+            if (!isInfo || depth < 0)
+                continue;
+
+            std::lock_guard<std::mutex> guard(clusterMutex);
+            self.nodes = nodes;
+            if (!self.done && (depthMarks.empty() || depth > depthMarks.back().depth)) {
+                DepthMark mark{depth, elapsedSince(searchStart), clusterNodes()};
+                depthMarks.push_back(mark);
+                std::cout << "info cluster depth " << depth << " worker " << index << " time " << mark.timeMs
+                          << " nodes " << mark.nodes << " nps " << (mark.nodes * 1000 / (mark.timeMs + 1)) << "\n";
+            }
+
+        } else if (command == "done") {
+            std::lock_guard<std::mutex> guard(clusterMutex);
+            std::getline(iss >> std::ws, self.doneMessage);
+            self.done = true;
+            workerDone.notify_all();
+
+        } else if (command == "hello") {
+            iss >> self.threads;
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(clusterMutex);
+    self.done = true;
+    workerDone.notify_all();
+}
+
+bool clusterListen(int port, int numWorkers) {
+    // The reader threads index the worker list, it is only filled while none are running
+    if (!workers.empty() || numWorkers < 1)
+        return false;
+
+    int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0)
+        return false;
+    int one = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listenFd, numWorkers) != 0) {
+        ::close(listenFd);
+        return false;
+    }
+
+    initEngineTables();
+
+    // Readers of the first workers run while the others connect, the vector must not reallocate
+    workers.reserve(numWorkers);
+
+    std::cout << "Waiting for " << numWorkers << " workers on port " << port << "\n";
+    while (static_cast<int>(workers.size()) < numWorkers) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+        auto link = std::make_unique<WorkerLink>();
+        link->conn = std::make_unique<Connection>(fd);
+        workers.push_back(std::move(link));
+        workers.back()->reader = std::thread(readerLoop, workers.size() - 1);
+        std::cout << "Worker " << (workers.size() - 1) << " connected\n";
+    }
+    ::close(listenFd);
+    return true;
+}
+
+size_t clusterWorkers() {
+    return workers.size();
+}
+
+void clusterShutdown() {
+    for (auto& w : workers) {
+        w->conn->sendLine("quit");
+        w->conn->shutdown();
+    }
+    for (auto& w : workers)
+        if (w->reader.joinable())
+            w->reader.join();
+    workers.clear();
+}
+
+// The reader threads must not outlive the program
+static struct ClusterCleanup {
+    ~ClusterCleanup() { clusterShutdown(); }
+} clusterCleanup;
+
+static void broadcast(const std::string& message) {
+    for (size_t i = 0; i < participants.load(); ++i)
+        workers[i]->conn->sendLine(message);
+}
+
+/**
+ * runCluster - Runs one search on the first @count workers and waits until all of them are done.
+ */
+static ClusterRun runCluster(const BoardState& board, const SearchLimits& limits,
+                             const std::vector<uint64_t>& history, size_t count) {
+    ClusterRun run;
+    {
+        std::lock_guard<std::mutex> guard(clusterMutex);
+        participants = count;
+        depthMarks.clear();
+        for (size_t i = 0; i < count; ++i) {
+            workers[i]->done = false;
+            workers[i]->nodes = 0;
+            workers[i]->doneMessage.clear();
+        }
+        searchStart = std::chrono::steady_clock::now();
+    }
+
+    std::string keys = "history " + std::to_string(history.size());
+    for (uint64_t key : history)
+        keys += " " + std::to_string(key);
+    broadcast(keys);
+    broadcast("search " + std::to_string(limits.maxDepth) + " " + std::to_string(limits.softTimeMs) + " " +
+              std::to_string(limits.moveTimeMs) + " " + std::to_string(limits.maxNodes) + " " +
+              bitboardsToFEN(board));
+
+    // The first worker to finish ends the search for all
+    std::unique_lock<std::mutex> lk(clusterMutex);
+    workerDone.wait(lk, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            if (workers[i]->done) return true;
+        return false;
+    });
+    lk.unlock();
+    broadcast("stop");
+    lk.lock();
+    workerDone.wait(lk, [&]() {
+        for (size_t i = 0; i < count; ++i)
+            if (!workers[i]->done) return false;
+        return true;
+    });
+    run.timeMs = elapsedSince(searchStart);
+    run.marks = depthMarks;
+
+    // The deepest completed iteration wins
+    for (size_t i = 0; i < count; ++i) {
+        std::istringstream iss(workers[i]->doneMessage);
+        int depth = 0, score = 0;
+        uint64_t nodes = 0;
+        if (!(iss >> depth >> score >> nodes))
+            continue;
+        run.nodes += nodes;
+
+        std::vector<Move> pv = readLineOfMoves(board, iss);
+        if (!pv.empty() && (!run.result.found || depth > run.result.depth)) {
+            run.result.found = true;
+            run.result.bestMove = pv.front();
+            run.result.score = score;
+            run.result.depth = depth;
+            run.result.pv = pv;
+        }
+    }
+    participants = 0;
+    return run;
+}
+
+SearchResult clusterSearch(const BoardState& board, const SearchLimits& limits,
+                           const std::vector<uint64_t>& history, size_t numWorkers) {
+    size_t count = (numWorkers == 0) ? workers.size() : std::min(numWorkers, workers.size());
+    ClusterRun run = runCluster(board, limits, history, count);
+    std::cout << "Cluster: " << count << " workers, " << run.nodes << " nodes " << run.timeMs << " ms "
+              << (run.nodes * 1000 / (run.timeMs + 1)) << " nps\n";
+    return run.result;
+}
+
+void clusterCompare(const BoardState& board, const SearchLimits& limits) {
+    size_t all = workers.size();
+    ClusterRun runs[2];
+    for (int r = 0; r < 2; ++r) {
+        participants = all;
+        broadcast("clear");
+        runs[r] = runCluster(board, limits, {}, r == 0 ? 1 : all);
+    }
+
+    std::cout << "\nDepth  1 worker (ms)  " << all << " workers (ms)  speedup\n";
+    for (const DepthMark& single : runs[0].marks) {
+        auto it = std::find_if(runs[1].marks.begin(), runs[1].marks.end(),
+                               [&](const DepthMark& m) { return m.depth == single.depth; });
+        std::cout << single.depth << "  " << single.timeMs << "  ";
+        if (it == runs[1].marks.end())
+            std::cout << "-  -\n";
+        else
+            std::cout << it->timeMs << "  " << (static_cast<double>(single.timeMs + 1) / (it->timeMs + 1)) << "\n";
+    }
+    for (int r = 0; r < 2; ++r)
+        std::cout << (r == 0 ? "1 worker: " : "Cluster: ") << runs[r].nodes << " nodes " << runs[r].timeMs << " ms "
+                  << (runs[r].nodes * 1000 / (runs[r].timeMs + 1)) << " nps, depth " << runs[r].result.depth
+                  << " best move " << (runs[r].result.found ? moveToString(runs[r].result.bestMove) : "none") << "\n";
+}
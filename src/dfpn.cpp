@@ -0,0 +1,451 @@
+// dfpn.cpp - Depth-first proof-number search (Nagai's df-pn) for forced mates.
+// OR nodes are positions with the attacker (the root side) to move, AND nodes have the
+// defender to move. A proof number is the number of leaves still needed to prove the mate,
+// a disproof number the number needed to refute it; the search always expands the most
+// proving node and only returns to the parent once one of its thresholds is exceeded.
+
+#include "dfpn.h"
+#include "movegen.h"
+#include "updateBoard.h"
+#include "zobrist.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+
+
+// ============================================================================
+//  SECTION 1: PROOF TABLE
+// ============================================================================
+
+// Disproofs that do not rest on a repetition of an earlier position or the ply limit
+constexpr uint16_t DFPN_NO_LOOP = UINT16_MAX;
+
+struct DfpnEntry {
+    uint64_t key = 0;
+    uint32_t pn = 1;         // proof number, 0 = mate proven
+    uint32_t dn = 1;         // disproof number, 0 = no mate
+    uint32_t work = 0;       // expansions spent below the entry, the replacement priority
+    uint16_t distance = 0;   // proven entries: plies to mate along the proof
+    uint16_t loop = DFPN_NO_LOOP; // disproved entries: shallowest path index the disproof depends on
+    uint64_t pathKey = 0;    // path-dependent disproofs: keys of the path they hold for, xor-ed
+};
+
+// Entries per bucket, an entry is looked up in the bucket of its key only
+constexpr size_t DFPN_BUCKET = 4;
+
+/**
+ * @brief Fixed-size proof/disproof hash table, one per solver thread.
+ * A new entry always gets stored: it replaces its own key or the bucket entry that took the
+ * least work to compute, so the node just searched is never lost to its parent.
+ */
+class ProofTable {
+public:
+    explicit ProofTable(size_t mb) {
+        size_t buckets = 1;
+        while (buckets * 2 * DFPN_BUCKET * sizeof(DfpnEntry) <= mb * 1024 * 1024)
+            buckets *= 2;
+        entries.resize(buckets * DFPN_BUCKET);
+        mask = buckets - 1;
+    }
+
+    bool probe(uint64_t key, DfpnEntry& out) const {
+        const DfpnEntry* bucket = &entries[(key & mask) * DFPN_BUCKET];
+        for (size_t i = 0; i < DFPN_BUCKET; ++i) {
+            if (bucket[i].key == key) {
+                out = bucket[i];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void store(const DfpnEntry& entry) {
+        DfpnEntry* bucket = &entries[(entry.key & mask) * DFPN_BUCKET];
+        DfpnEntry* victim = &bucket[0];
+        for (size_t i = 0; i < DFPN_BUCKET; ++i) {
+            if (bucket[i].key == entry.key || bucket[i].key == 0) {
+                victim = &bucket[i];
+                break;
+            }
+            // Solved entries are worth keeping, they are never recomputed cheaply
+            if (priority(bucket[i]) < priority(*victim))
+                victim = &bucket[i];
+        }
+        *victim = entry;
+    }
+
+    size_t used() const {
+        return std::count_if(entries.begin(), entries.end(), [](const DfpnEntry& e) { return e.key != 0; });
+    }
+
+private:
+    std::vector<DfpnEntry> entries;
+    size_t mask = 0;
+
+    static uint64_t priority(const DfpnEntry& e) {
+        bool solved = e.pn == 0 || (e.dn == 0 && e.loop == DFPN_NO_LOOP);
+        return e.work + (solved ? uint64_t(UINT32_MAX) + 1 : 0);
+    }
+};
+
+
+// ============================================================================
+//  SECTION 2: SOLVER
+// ============================================================================
+
+/**
+ * @brief Weak proof-number sum (Ueda et al.): largest child number plus one per other unsolved child.
+ * Plain sums count a transposed subtree once per path and overflow in long endgame proofs.
+ */
+struct WeakSum {
+    uint32_t largest = 0;
+    uint32_t count = 0;   // children with a non-zero number
+
+    void add(uint32_t number) {
+        if (number == 0)
+            return;
+        largest = std::max(largest, number);
+        count++;
+    }
+
+    uint32_t value() const {
+        if (largest >= DFPN_INF)
+            return DFPN_INF;
+        if (count == 0)
+            return 0;
+        return static_cast<uint32_t>(std::min<uint64_t>(uint64_t(largest) + count - 1, DFPN_INF - 1));
+    }
+};
+
+/**
+ * @brief One df-pn search thread: its proof table and the line it is currently on.
+ */
+class DfpnSolver {
+public:
+    DfpnSolver(size_t hashMb, bool attackerWhite, uint64_t maxNodes,
+               std::atomic<uint64_t>& totalNodes, std::atomic<bool>& stop)
+        : table(hashMb), attackerWhite(attackerWhite), maxNodes(maxNodes),
+          totalNodes(totalNodes), stop(stop) {}
+
+    /**
+     * solve - Runs df-pn from @board (at @ply from the real root) until it is solved, its proof
+     * number reaches @threshold or the search stops.
+     * @before: Keys of the positions leading to @board, for repetition detection.
+     * Returns the entry of @board.
+     */
+    DfpnEntry solve(const BoardState& board, int ply, const std::vector<uint64_t>& before,
+                    uint32_t threshold = DFPN_INF) {
+        path = before;
+        pathKey = 0;
+        for (uint64_t k : before)
+            pathKey ^= k;
+        uint64_t key = computeZobristKey(board);
+        mid(board, key, ply, threshold, DFPN_INF);
+        flush();
+
+        DfpnEntry entry;
+        entry.key = key;
+        table.probe(key, entry);
+        return entry;
+    }
+
+    /**
+     * mateLine - Follows the proof from @board: the attacker takes the fastest proven move,
+     * the defender the longest resistance.
+     */
+    std::vector<Move> mateLine(const BoardState& board) const {
+        std::vector<Move> line;
+        BoardState current = board;
+        std::vector<uint64_t> seen;
+
+        while (static_cast<int>(line.size()) < DFPN_MAX_PLY) {
+            uint64_t key = computeZobristKey(current);
+            if (std::find(seen.begin(), seen.end(), key) != seen.end())
+                break;
+            seen.push_back(key);
+
+            bool orNode = (current.whiteToMove == attackerWhite);
+            MoveList moves = generateLegalMoves(current);
+            bool found = false;
+            Move best{};
+            int bestDistance = orNode ? DFPN_MAX_PLY + 1 : -1;
+
+            for (const Move& m : moves.moves) {
+                BoardState child = current;
+                updateGameState(child, m);
+                applyMove(child, m);
+                DfpnEntry e;
+                if (!table.probe(computeZobristKey(child), e) || e.pn != 0)
+                    continue;
+                if (orNode ? e.distance < bestDistance : e.distance > bestDistance) {
+                    bestDistance = e.distance;
+                    best = m;
+                    found = true;
+                }
+            }
+            if (!found)
+                break;
+
+            line.push_back(best);
+            updateGameState(current, best);
+            applyMove(current, best);
+        }
+        return line;
+    }
+
+    size_t tableEntries() const { return table.used(); }
+
+private:
+    struct Child {
+        BoardState board;
+        uint64_t key;
+    };
+
+    ProofTable table;
+    bool attackerWhite;
+    uint64_t maxNodes;
+    std::atomic<uint64_t>& totalNodes;
+    std::atomic<bool>& stop;
+    std::vector<uint64_t> path;
+    uint64_t pathKey = 0;     // xor of the keys in path
+    uint64_t localNodes = 0;
+
+    void flush() {
+        totalNodes.fetch_add(localNodes, std::memory_order_relaxed);
+        localNodes = 0;
+    }
+
+    bool outOfBudget() {
+        if (localNodes >= 1024) {
+            flush();
+            if (maxNodes && totalNodes.load(std::memory_order_relaxed) >= maxNodes)
+                stop = true;
+        }
+        return stop.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * lookup - Proof and disproof numbers of a child, from the table or the defaults of a fresh node.
+     * A disproof that rests on a repetition or the ply limit only holds on the path it was found on
+     * (the graph history interaction), on another path the child counts as unsolved again.
+     */
+    DfpnEntry lookup(const Child& child, int ply) const {
+        DfpnEntry e;
+        e.key = child.key;
+        auto repeated = std::find(path.begin(), path.end(), child.key);
+        if (ply >= DFPN_MAX_PLY || repeated != path.end()) {
+            e.pn = DFPN_INF; // too deep or a repetition: no mate this way
+            e.dn = 0;
+            e.loop = static_cast<uint16_t>(repeated != path.end() ? repeated - path.begin() : 0);
+            return e;
+        }
+        if (table.probe(child.key, e) && e.dn == 0 && e.loop != DFPN_NO_LOOP && e.pathKey != pathKey) {
+            e.pn = 1;
+            e.dn = 1;
+            e.loop = DFPN_NO_LOOP;
+        }
+        return e;
+    }
+
+    /**
+     * mid - Multiple iterative deepening: expands @board until its proof number reaches
+     * @thpn or its disproof number reaches @thdn, then stores it and returns.
+     */
+    void mid(const BoardState& board, uint64_t key, int ply, uint32_t thpn, uint32_t thdn) {
+        uint64_t nodesBefore = totalNodes.load(std::memory_order_relaxed) + localNodes;
+        ++localNodes;
+        bool orNode = (board.whiteToMove == attackerWhite);
+
+        DfpnEntry entry;
+        entry.key = key;
+        table.probe(key, entry);
+
+        MoveList moves = generateLegalMoves(board);
+        if (moves.moves.empty()) {
+            // The attacker without moves or a stalemated defender: no mate. A mated defender: proven.
+            bool mate = !orNode && isInCheck(board);
+            entry.pn = mate ? 0 : DFPN_INF;
+            entry.dn = mate ? DFPN_INF : 0;
+            entry.distance = 0;
+            entry.loop = DFPN_NO_LOOP;
+            table.store(entry);
+            return;
+        }
+
+        std::vector<Child> children;
+        children.reserve(moves.moves.size());
+        for (const Move& m : moves.moves) {
+            Child c{board, 0};
+            updateGameState(c.board, m);
+            applyMove(c.board, m);
+            c.key = computeZobristKey(c.board);
+            children.push_back(c);
+        }
+
+        path.push_back(key);
+        pathKey ^= key;
+        while (true) {
+            // OR node: proof = cheapest child proof, disproof = all children disproved. AND: the reverse.
+            uint32_t cheapest = DFPN_INF;
+            WeakSum sum;
+            size_t best = 0;
+            uint32_t bestValue = DFPN_INF + 1, secondValue = DFPN_INF;
+            int minProvenDistance = DFPN_MAX_PLY, maxDistance = 0;
+            // Disproofs: OR nodes depend on every child, AND nodes on their least dependent refutation
+            uint16_t loop = orNode ? DFPN_NO_LOOP : 0;
+
+            for (size_t i = 0; i < children.size(); ++i) {
+                DfpnEntry c = lookup(children[i], ply + 1);
+                uint32_t value = orNode ? c.pn : c.dn;
+                cheapest = std::min(cheapest, value);
+                sum.add(orNode ? c.dn : c.pn);
+                if (c.pn == 0) {
+                    minProvenDistance = std::min<int>(minProvenDistance, c.distance);
+                    maxDistance = std::max<int>(maxDistance, c.distance);
+                }
+                if (c.dn == 0)
+                    loop = orNode ? std::min(loop, c.loop) : std::max(loop, c.loop);
+                if (value < bestValue) {
+                    secondValue = bestValue;
+                    bestValue = value;
+                    best = i;
+                } else if (value < secondValue) {
+                    secondValue = value;
+                }
+            }
+
+            uint32_t pn = orNode ? cheapest : sum.value();
+            uint32_t dn = orNode ? sum.value() : cheapest;
+            entry.pn = pn;
+            entry.dn = dn;
+            if (pn == 0)
+                entry.distance = static_cast<uint16_t>(1 + (orNode ? minProvenDistance : maxDistance));
+            // A repetition of this node itself or of a position below it does not depend on the path
+            entry.loop = (dn == 0 && loop < path.size() - 1) ? loop : DFPN_NO_LOOP;
+
+            if (pn >= thpn || dn >= thdn || pn == 0 || dn == 0 || outOfBudget())
+                break;
+
+            // Thresholds of the most proving child: it may grow a little beyond its best brother (the
+            // 1+epsilon trick, against switching back and forth between two brothers every expansion),
+            // or until its other number alone lifts the weak sum of this node over the threshold
+            uint32_t brotherLimit = static_cast<uint32_t>(std::min<uint64_t>(
+                uint64_t(secondValue) + secondValue / 4 + 1, DFPN_INF));
+            uint32_t childThpn, childThdn;
+            if (orNode) {
+                childThpn = std::min(thpn, brotherLimit);
+                childThdn = thdn >= DFPN_INF ? DFPN_INF : thdn - (sum.count - 1);
+            } else {
+                childThdn = std::min(thdn, brotherLimit);
+                childThpn = thpn >= DFPN_INF ? DFPN_INF : thpn - (sum.count - 1);
+            }
+
+            mid(children[best].board, children[best].key, ply + 1, childThpn, childThdn);
+        }
+        path.pop_back();
+        pathKey ^= key;
+        entry.pathKey = entry.loop != DFPN_NO_LOOP ? pathKey : 0;
+
+        uint64_t spent = totalNodes.load(std::memory_order_relaxed) + localNodes - nodesBefore;
+        entry.work = static_cast<uint32_t>(std::min<uint64_t>(entry.work + spent, UINT32_MAX));
+        table.store(entry);
+    }
+};
+
+
+// ============================================================================
+//  SECTION 3: ROOT
+// ============================================================================
+
+MateResult solveMate(const BoardState& board, uint64_t maxNodes, size_t hashMb, int numThreads, ThreadPool& pool) {
+    MateResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    std::atomic<uint64_t> totalNodes{0};
+    std::atomic<bool> stop{false};
+    bool attackerWhite = board.whiteToMove;
+    numThreads = std::max(1, numThreads);
+
+    if (numThreads == 1) {
+        // Plain df-pn from the root, it picks the most promising root move by itself
+        DfpnSolver solver(hashMb, attackerWhite, maxNodes, totalNodes, stop);
+        DfpnEntry root = solver.solve(board, 0, {});
+        result.proven = (root.pn == 0);
+        result.disproven = (root.dn == 0);
+        if (result.proven) {
+            result.distance = root.distance;
+            result.line = solver.mateLine(board);
+        }
+        result.tableEntries = solver.tableEntries();
+    } else {
+        // Root split: the root moves are dealt out to the threads, each proving or refuting the
+        // defender nodes of its moves in its own table. The threads work in rounds with a doubling
+        // proof-number threshold, so an easy mate behind a late root move is not starved by
+        // earlier moves that can never be disproved; the first proof stops the others.
+        MoveList rootMoves = generateLegalMoves(board);
+        std::vector<BoardState> children;
+        for (const Move& m : rootMoves.moves) {
+            BoardState child = board;
+            updateGameState(child, m);
+            applyMove(child, m);
+            children.push_back(child);
+        }
+
+        std::vector<std::unique_ptr<DfpnSolver>> solvers;
+        for (int t = 0; t < numThreads; ++t)
+            solvers.push_back(std::make_unique<DfpnSolver>(std::max<size_t>(1, hashMb / numThreads),
+                              attackerWhite, maxNodes, totalNodes, stop));
+
+        std::vector<char> solved(children.size(), 0);
+        std::vector<char> disproved(children.size(), 0);
+        std::mutex resultMutex;
+        std::vector<uint64_t> rootPath = {computeZobristKey(board)};
+
+        for (uint32_t threshold = 2; !stop.load(); threshold = std::min<uint64_t>(uint64_t(threshold) * 2, DFPN_INF)) {
+            std::vector<std::future<void>> tasks;
+            for (int t = 0; t < numThreads; ++t) {
+                tasks.push_back(pool.enqueue([&, t]() {
+                    DfpnSolver& solver = *solvers[t];
+                    for (size_t i = t; i < children.size() && !stop.load(); i += numThreads) {
+                        if (solved[i])
+                            continue;
+
+                        DfpnEntry e = solver.solve(children[i], 1, rootPath, threshold);
+                        if (e.dn == 0) {
+                            solved[i] = disproved[i] = 1;
+                        } else if (e.pn == 0) {
+                            solved[i] = 1;
+                            std::lock_guard<std::mutex> guard(resultMutex);
+                            if (!result.proven || e.distance + 1 < result.distance) {
+                                result.proven = true;
+                                result.distance = e.distance + 1;
+                                result.line = solver.mateLine(children[i]);
+                                result.line.insert(result.line.begin(), rootMoves.moves[i]);
+                            }
+                            stop = true;
+                        }
+                    }
+                }));
+            }
+            for (auto& task : tasks)
+                task.get();
+
+            if (std::all_of(solved.begin(), solved.end(), [](char s) { return s != 0; }))
+                break;
+        }
+
+        for (const auto& solver : solvers)
+            result.tableEntries += solver->tableEntries();
+        result.disproven = !result.proven &&
+                           std::all_of(disproved.begin(), disproved.end(), [](char d) { return d != 0; });
+    }
+
+    result.nodes = totalNodes.load();
+    result.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -14,6 +14,11 @@
 #include <string>
 #include <vector>
 #include <future>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <sstream>
+#include <mutex>
 
 #include "engine.h"
 #include "movegen.h"
@@ -25,9 +30,240 @@
 #include "threadPool.h"
 #include "zobrist.h"
 #include "transposition.h"
+#include "searchController.h"
+#include "timeManager.h"
+#include "dfpn.h"
+#include "cluster.h"
 
 TranspositionTable TT(64); // 64 MB global TT
 
+const int MAX_SEARCH_DEPTH = 64;   // iterative deepening depth cap
+const int SEARCH_TIME_MS = 2000;   // soft time budget per move
+const int BENCH_DEPTH = 7;         // fixed depth searched by the bench command
+const int BENCH_SMP_MS = 1000;     // time per bench position and thread count of "bench smp"
+const uint64_t MATE_NODES = 10000000; // default expansion budget of the mate solver
+const size_t MATE_HASH_MB = 64;       // proof table memory of the mate solver
+
+// Search configuration, changed with the "threads <n>", "mode <lazysmp|rootsplit|ybwc|mcts>" and "multipv <k>" commands
+static int searchThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+static SearchMode searchMode = LAZY_SMP;
+static int multiPvLines = 1;
+
+// Game clock for "2", set with "clock ..."; without it every move gets SEARCH_TIME_MS
+static TimeControl gameClock;
+
+// Pondering ("ponder on"): after answering "2", search the position after the expected reply
+static bool ponderEnabled = false;
+
+/**
+ * @brief Reads "<name> <value>" pairs of a clock description into tc.
+ * Returns false on an unknown name or a missing value, other pairs are left to @other.
+ */
+template <typename OtherKey>
+static bool parseClock(std::istringstream& iss, TimeControl& tc, OtherKey other) {
+    std::string key, value;
+    while (iss >> key) {
+        if (!(iss >> value)) return false;
+        if (key == "wtime") tc.wtime = std::stoi(value);
+        else if (key == "btime") tc.btime = std::stoi(value);
+        else if (key == "winc") tc.winc = std::stoi(value);
+        else if (key == "binc") tc.binc = std::stoi(value);
+        else if (key == "movestogo") tc.movestogo = std::stoi(value);
+        else if (!other(key, value)) return false;
+    }
+    return true;
+}
+
+// Positions searched by the bench command
+static const std::vector<std::string> BENCH_POSITIONS = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+/**
+ * @brief The game played through engine(), "newgame" starts a fresh one with reset().
+ * Its search side, the game history and the expected line, lives in the default search context.
+ */
+struct GameSession {
+    // Background search, shared by "2", "go", "stop" and "bench"
+    SearchController searchController;
+
+    // Keys of the current game's positions since the last capture or pawn move, oldest first
+    std::vector<uint64_t> gameKeys;
+
+    // Principal variation of the engine's last game move and the position it was searched from
+    std::vector<Move> lastPv;
+    BoardState lastPvRoot{};
+
+    bool pondering = false;   // a ponder search was started and not yet resolved
+    uint64_t ponderKey = 0;   // key of the position the ponder search is for
+
+    /**
+     * reset - Stops the search, replaces the search threads (empty history tables) and forgets
+     * the game, in this object and in the search context.
+     */
+    void reset() {
+        searchController.resetThreads();
+        gameKeys.clear();
+        lastPv.clear();
+        lastPvRoot = BoardState{};
+        pondering = false;
+        ponderKey = 0;
+
+        SearchContext& context = defaultSearchContext();
+        context.gameHistory.clear();
+        context.expectedLine.clear();
+    }
+};
+
+static GameSession session;
+
+// The keys must not change during a session or the TT and the game history turn useless
+void initEngineTables() {
+    static std::once_flag once;
+    std::call_once(once, []() {
+        initZobrist();
+        initAttackTables();
+    });
+}
+
+/**
+ * @brief Hands the game history before the given root position to the search.
+ * Only a FEN reaches the engine, so the history is made of the positions it has seen: the
+ * ones it searched and the ones its moves led to. Zobrist tables must be initialized.
+ */
+static void updateGameHistory(const BoardState& board) {
+    uint64_t rootKey = computeZobristKey(board);
+
+    // The root itself is not part of its history (self-play passes the position after our move)
+    if (!session.gameKeys.empty() && session.gameKeys.back() == rootKey)
+        session.gameKeys.pop_back();
+
+    // Positions before the last irreversible move cannot repeat
+    size_t reversible = static_cast<size_t>(std::max(0, board.halfmoveClock));
+    if (session.gameKeys.size() > reversible)
+        session.gameKeys.erase(session.gameKeys.begin(), session.gameKeys.end() - reversible);
+
+    setGameHistory(session.gameKeys);
+}
+
+/**
+ * @brief Adds the searched position and the position after the chosen move to the game history.
+ */
+static void recordGameMove(const BoardState& board, const SearchResult& result) {
+    session.gameKeys.push_back(computeZobristKey(board));
+    session.lastPv = result.pv;
+    session.lastPvRoot = board;
+    if (!result.found)
+        return;
+
+    BoardState next = board;
+    updateGameState(next, result.bestMove);
+    applyMove(next, result.bestMove);
+    session.gameKeys.push_back(computeZobristKey(next));
+}
+
+/**
+ * @brief Rest of the engine's last principal variation if the game followed it to board, else empty.
+ * The game is one ply further in self-play, where the engine also plays the reply, and two
+ * plies further when the opponent played the expected reply.
+ */
+static std::vector<Move> expectedLine(const BoardState& board) {
+    uint64_t key = computeZobristKey(board);
+    BoardState line = session.lastPvRoot;
+    for (size_t ply = 0; ply < 2 && ply < session.lastPv.size(); ++ply) {
+        updateGameState(line, session.lastPv[ply]);
+        applyMove(line, session.lastPv[ply]);
+        if (computeZobristKey(line) == key)
+            return std::vector<Move>(session.lastPv.begin() + ply + 1, session.lastPv.end());
+    }
+    return {};
+}
+
+/**
+ * @brief Limits of a "2" search for the side to move: from the game clock if one is set.
+ */
+static SearchLimits moveLimits(const BoardState& board) {
+    SearchLimits limits;
+    limits.maxDepth = MAX_SEARCH_DEPTH;
+    limits.softTimeMs = SEARCH_TIME_MS;
+    limits.moveTimeMs = SEARCH_TIME_MS; // an iteration never runs past the budget
+    limits.multiPv = multiPvLines;
+
+    TimeBudget budget = allocateTime(gameClock, board.whiteToMove);
+    if (budget.hardMs > 0) {
+        limits.softTimeMs = budget.softMs;
+        limits.moveTimeMs = budget.hardMs;
+    }
+    return limits;
+}
+
+/**
+ * @brief Stops the background search, a ponder search included, and waits for it.
+ */
+static void stopSearch() {
+    session.searchController.stop();
+    session.searchController.wait();
+    session.pondering = false;
+}
+
+/**
+ * @brief Starts pondering on the position after our move and the expected reply (pv[1]).
+ * The search runs on our clock as if the reply had been played; "2" turns it into the real
+ * search if the reply comes, or stops it otherwise. The TT keeps what it found either way.
+ */
+static void startPondering(const BoardState& board, const SearchResult& result) {
+    if (!ponderEnabled || result.pv.size() < 2)
+        return;
+
+    BoardState ponderBoard = board;
+    for (int i = 0; i < 2; ++i) {
+        updateGameState(ponderBoard, result.pv[i]);
+        applyMove(ponderBoard, result.pv[i]);
+    }
+
+    SearchLimits limits = moveLimits(ponderBoard);
+    limits.ponder = true;
+
+    updateGameHistory(ponderBoard);
+    setExpectedLine(expectedLine(ponderBoard));
+    session.ponderKey = computeZobristKey(ponderBoard);
+    session.searchController.start(ponderBoard, limits, searchMode, searchThreads);
+    session.pondering = true;
+    std::cout << "Pondering on " << moveToString(result.pv[1]) << "\n";
+}
+
+/**
+ * @brief Prints the result of a finished search and returns its move ("ff" if there is none).
+ */
+static std::string reportResult(const SearchResult& result) {
+    if (!result.found) {
+        // No moves available
+        std::cout << "No legal moves found.\n\n";
+        return "ff";
+    }
+
+    // MultiPV: ranked list of the best moves
+    for (size_t k = 0; k < result.lines.size() && result.lines.size() > 1; ++k) {
+        const RootLine& line = result.lines[k];
+        std::cout << (k + 1) << ". " << moveToString(line.move) << " Evaluation: " << line.score << " PV:";
+        for (const Move& m : line.pv)
+            std::cout << " " << moveToString(m);
+        std::cout << "\n";
+    }
+
+    std::string bestMoveStr = moveToString(result.bestMove);
+    std::cout << "\nBest Move: " << bestMoveStr << " Evaluation: " << result.score
+              << " Depth: " << result.depth;
+    if (result.pv.size() > 1)
+        std::cout << " Ponder: " << moveToString(result.pv[1]);
+    std::cout << "\n";
+    return bestMoveStr;
+}
+
 // ============================================================================
 //  SECTION 1: Main loop
 // ============================================================================
@@ -40,12 +276,13 @@ TranspositionTable TT(64); // 64 MB global TT
 std::string engine(std::string command, std::string fenInput, BoardState& board) {
 
     //BoardState board = {}; // Initialize an empty board state
+    (void)fenInput; // the commands work on board
     
     if(command == "1"){
         //////////////////////// Functionality test ////////////////////////
 
         // Must always initialize the attack tables after each update, mandatory for functions like is legalmovestate
-        initAttackTables();
+        initEngineTables();
 
         // Check if the state is legal
         if(!isLegalMoveState(board)){
@@ -106,66 +343,330 @@ std::string engine(std::string command, std::string fenInput, BoardState& board)
     }else if (command == "2"){
         //////////////////////// Main implementation ////////////////////////
 
-        // Initiate zobrist hashing
-        initZobrist();
+        // Ponderhit: the opponent played the expected reply, the ponder search goes on with the clock running
+        if (session.pondering && computeZobristKey(board) == session.ponderKey) {
+            session.pondering = false;
+            std::cout << "Ponderhit\n";
+            session.searchController.ponderHit();
+            SearchResult result = session.searchController.wait();
+            recordGameMove(board, result);
+            std::string bestMoveStr = reportResult(result);
+            startPondering(board, result);
+            return bestMoveStr;
+        }
 
-        // Initialize attack tables and generate moves
-        initAttackTables();
-        MoveList moves = generateLegalMoves(board);
+        // Only one search runs at a time, finish a background search first
+        stopSearch();
+
+        // Zobrist keys and attack tables, once per session so the TT stays valid from move to move
+        initEngineTables();
+
+        //////////////////////// Iterative deepening on the search thread ////////////////////////
+        SearchLimits limits = moveLimits(board);
+
+        updateGameHistory(board);
+        setExpectedLine(expectedLine(board));
+
+        // Cluster: the worker processes search, this process only coordinates
+        if (clusterWorkers() > 0) {
+            SearchResult result = clusterSearch(board, limits, session.gameKeys);
+            recordGameMove(board, result);
+            return reportResult(result);
+        }
+
+        session.searchController.start(board, limits, searchMode, searchThreads);
+        SearchResult result = session.searchController.wait();
+        recordGameMove(board, result);
+        std::string bestMoveStr = reportResult(result);
+        startPondering(board, result);
+        return bestMoveStr;
+
+    }else if (command == "go" || command.rfind("go ", 0) == 0){
+        //////////////////////// Background search: go [depth <d>] [movetime <ms>] [nodes <n>] [wtime <ms> btime <ms> winc <ms> binc <ms> movestogo <n>] ////////////////////////
+        stopSearch();
+        initEngineTables();
+
+        SearchLimits limits;
+        limits.maxDepth = MAX_SEARCH_DEPTH;
+        limits.multiPv = multiPvLines;
+        std::istringstream iss(command.substr(2));
+        TimeControl tc;
+        tc.moveOverhead = gameClock.moveOverhead;
+        try {
+            bool valid = parseClock(iss, tc, [&](const std::string& key, const std::string& value) {
+                if (key == "depth") limits.maxDepth = std::max(1, std::min(MAX_SEARCH_DEPTH, std::stoi(value)));
+                else if (key == "movetime") limits.moveTimeMs = std::max(1, std::stoi(value));
+                else if (key == "nodes") limits.maxNodes = std::stoull(value);
+                else return false;
+                return true;
+            });
+            if (!valid) return "error";
+        } catch (...) { return "error"; }
+
+        // A fixed move time wins over the clock
+        TimeBudget budget = allocateTime(tc, board.whiteToMove);
+        if (limits.moveTimeMs == 0 && budget.hardMs > 0) {
+            limits.softTimeMs = budget.softMs;
+            limits.moveTimeMs = budget.hardMs;
+        }
+
+        updateGameHistory(board);
+        setExpectedLine(expectedLine(board));
+        session.searchController.start(board, limits, searchMode, searchThreads);
+        return "ok";
+
+    }else if (command == "stop"){
+        //////////////////////// Stop the background search, answer with the last completed iteration ////////////////////////
+        session.searchController.stop();
+        session.pondering = false;
+        return reportResult(session.searchController.wait());
+
+    }else if (command == "newgame"){
+        //////////////////////// New game: forget the game, the TT and the learnt move ordering ////////////////////////
+        session.reset();
+        TT.clear();
+        return "ok";
+
+    }else if (command.rfind("threads ", 0) == 0){
+        //////////////////////// Search thread count ////////////////////////
+        try { searchThreads = std::max(1, std::stoi(command.substr(8))); } catch (...) { return "error"; }
+        std::cout << "Search threads: " << searchThreads << "\n";
+        return "ok";
+
+    }else if (command.rfind("hash ", 0) == 0){
+        //////////////////////// Transposition table size in MB, the table starts empty ////////////////////////
+        size_t mb;
+        try { mb = std::stoul(command.substr(5)); } catch (...) { return "error"; }
+        stopSearch();
+        if (!TT.resize(mb))
+            return "error";
+        std::cout << "Hash: " << TT.sizeMb() << " MB" << (TT.hugePages() ? " (huge pages)" : "") << "\n";
+        return "ok";
 
-        //////////////////////// Min-max with thread Pool Implementation ////////////////////////
-        size_t numThreads = 11;
-        ThreadPool pool(numThreads);
+    }else if (command.rfind("clock ", 0) == 0){
+        //////////////////////// Game clock for "2": clock wtime <ms> btime <ms> [winc <ms>] [binc <ms>] [movestogo <n>] ////////////////////////
+        std::istringstream iss(command.substr(6));
+        TimeControl tc;
+        tc.moveOverhead = gameClock.moveOverhead;
+        try {
+            if (!parseClock(iss, tc, [](const std::string&, const std::string&) { return false; }))
+                return "error";
+        } catch (...) { return "error"; }
+        gameClock = tc;
+        return "ok";
 
-        std::vector<std::future<std::pair<Move, int>>> futures;
+    }else if (command.rfind("overhead ", 0) == 0){
+        //////////////////////// Time reserved per move for GUI and communication lag ////////////////////////
+        try { gameClock.moveOverhead = std::max(0, std::stoi(command.substr(9))); } catch (...) { return "error"; }
+        std::cout << "Move overhead: " << gameClock.moveOverhead << " ms\n";
+        return "ok";
 
-        // Enqueue tasks in the pool
-        for (const auto& m : moves.moves) {
-            futures.push_back(pool.enqueue([board, m]() -> std::pair<Move,int> {
-                BoardState newBoard = board;
+    }else if (command.rfind("ponder ", 0) == 0){
+        //////////////////////// Pondering on the opponent's time: ponder <on|off> ////////////////////////
+        std::string value = command.substr(7);
+        if (value != "on" && value != "off") return "error";
+        ponderEnabled = (value == "on");
+        if (!ponderEnabled && session.pondering) stopSearch();
+        std::cout << "Ponder: " << value << "\n";
+        return "ok";
 
-                updateGameState(newBoard, m);
-                applyMove(newBoard, m);
+    }else if (command.rfind("multipv ", 0) == 0){
+        //////////////////////// Number of lines of the analysis (MultiPV) ////////////////////////
+        try { multiPvLines = std::max(1, std::stoi(command.substr(8))); } catch (...) { return "error"; }
+        std::cout << "MultiPV: " << multiPvLines << "\n";
+        return "ok";
 
-                if (!isLegalMoveState(newBoard)) {
-                    return {m, std::numeric_limits<int>::min()};
-                }
+    }else if (command.rfind("mode ", 0) == 0){
+        //////////////////////// Parallel search algorithm ////////////////////////
+        std::string name = command.substr(5);
+        if (name == "lazysmp") searchMode = LAZY_SMP;
+        else if (name == "rootsplit") searchMode = ROOT_SPLIT;
+        else if (name == "ybwc") searchMode = YBWC;
+        else if (name == "mcts") searchMode = MCTS;
+        else return "error";
+        std::cout << "Search mode: " << name << "\n";
+        return "ok";
 
-                // int eval = minimax(newBoard, 3, false);
-                int eval = minimax(newBoard, 3, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), false);
-                return {m, eval};
-            }));
+    }else if (command.rfind("set ", 0) == 0){
+        //////////////////////// Selective search switches ////////////////////////
+        std::istringstream iss(command.substr(4));
+        std::string name, value;
+        iss >> name >> value;
+        if (value != "on" && value != "off") return "error";
+        bool enabled = (value == "on");
+
+        // The search threads read the options, a running search (or ponder) ends first
+        stopSearch();
+        SearchOptions& searchOptions = defaultSearchContext().options;
+        if (name == "nullmove") searchOptions.nullMove = enabled;
+        else if (name == "lmr") searchOptions.lateMoveReductions = enabled;
+        else if (name == "rfp") searchOptions.reverseFutility = enabled;
+        else if (name == "futility") searchOptions.futility = enabled;
+        else if (name == "razoring") searchOptions.razoring = enabled;
+        else if (name == "lmp") searchOptions.lateMovePruning = enabled;
+        else if (name == "checkext") searchOptions.checkExtensions = enabled;
+        else if (name == "qchecks") searchOptions.quiescenceChecks = enabled;
+        else return "error";
+        std::cout << "Option " << name << ": " << value << "\n";
+        return "ok";
+
+    }else if (command == "mate" || command.rfind("mate ", 0) == 0){
+        //////////////////////// Proof-number mate solver: mate [nodes <n>] [hash <mb>] ////////////////////////
+        std::istringstream iss(command.substr(4));
+        uint64_t maxNodes = MATE_NODES;
+        size_t hashMb = MATE_HASH_MB;
+        std::string key, value;
+        try {
+            while (iss >> key) {
+                if (!(iss >> value)) return "error";
+                if (key == "nodes") maxNodes = std::stoull(value);
+                else if (key == "hash") hashMb = std::max<size_t>(1, std::stoull(value));
+                else return "error";
+            }
+        } catch (...) { return "error"; }
+
+        stopSearch();
+        initEngineTables();
+
+        ThreadPool pool(searchThreads);
+        MateResult result = solveMate(board, maxNodes, hashMb, searchThreads, pool);
+
+        std::string line;
+        for (const Move& m : result.line)
+            line += moveToString(m) + " ";
+
+        if (result.proven)
+            std::cout << "Mate in " << (result.distance + 1) / 2 << ": " << line << "\n";
+        else if (result.disproven)
+            std::cout << "No forced mate\n";
+        else
+            std::cout << "Unknown (node limit reached)\n";
+        std::cout << "Nodes: " << result.nodes << " Time: " << result.timeMs << " ms NPS: "
+                  << (result.nodes * 1000 / (result.timeMs + 1)) << " Proof table entries: "
+                  << result.tableEntries << "\n";
+
+        if (!result.proven) return result.disproven ? "none" : "unknown";
+        return result.line.empty() ? "none" : moveToString(result.line.front());
+
+    }else if (command.rfind("cluster ", 0) == 0){
+        //////////////////////// Cluster coordinator: cluster listen <port> <workers> | cluster compare [depth <d>] [movetime <ms>] | cluster quit ////////////////////////
+        std::istringstream iss(command.substr(8));
+        std::string action;
+        iss >> action;
+
+        if (action == "listen") {
+            int port = 0, workers = 0;
+            if (!(iss >> port >> workers) || workers < 1) return "error";
+            stopSearch();
+            return clusterListen(port, workers) ? "ok" : "error";
+        }
+        if (action == "quit") {
+            clusterShutdown();
+            return "ok";
         }
+        if (action != "compare" || clusterWorkers() == 0) return "error";
 
-        // Collect results and find the best move
-        Move bestMove;
-        int bestEval = std::numeric_limits<int>::min();
-        bool foundMove = false;
-
-        for (auto &fut : futures) {
-            auto [move, eval] = fut.get();
-            if (eval > bestEval) {
-                bestEval = eval;
-                bestMove = move;
-                foundMove = true;
+        SearchLimits limits;
+        limits.maxDepth = MAX_SEARCH_DEPTH;
+        limits.softTimeMs = SEARCH_TIME_MS;
+        std::string key, value;
+        try {
+            while (iss >> key >> value) {
+                if (key == "depth") { limits.maxDepth = std::stoi(value); limits.softTimeMs = 0; }
+                else if (key == "movetime") limits.softTimeMs = limits.moveTimeMs = std::stoi(value);
+                else return "error";
             }
+        } catch (...) { return "error"; }
+
+        clusterCompare(board, limits);
+        return "ok";
+
+    }else if (command.rfind("worker ", 0) == 0){
+        //////////////////////// Cluster worker: worker <host> <port>, serves the coordinator until it quits ////////////////////////
+        std::istringstream iss(command.substr(7));
+        std::string host;
+        int port = 0;
+        if (!(iss >> host >> port)) return "error";
+        stopSearch();
+        TT.clear();
+        return clusterWorker(host, port, searchMode, searchThreads) ? "ok" : "error";
+
+    }else if (command == "bench"){
+        //////////////////////// Fixed-depth node count benchmark ////////////////////////
+        stopSearch();
+        initEngineTables();
+
+        // Always one thread, whatever "threads" and "mode" say (a single Lazy SMP thread is the
+        // plain serial search), so the node count is the same on every run and machine.
+        // Thread scaling is measured by "bench smp".
+        SearchLimits limits;
+        limits.maxDepth = BENCH_DEPTH;
+
+        uint64_t totalNodes = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (const auto& fen : BENCH_POSITIONS) {
+            // Every position starts like a new game, with empty tables
+            TT.clear();
+            session.searchController.resetThreads();
+
+            BoardState benchBoard = parseFEN(fen);
+            setGameHistory({});
+            setExpectedLine({});
+            session.searchController.start(benchBoard, limits, LAZY_SMP, 1);
+            SearchResult result = session.searchController.wait();
+            totalNodes += defaultSearchContext().nodes.load();
+
+            std::cout << "Position: " << fen << "\nBest Move: " << moveToString(result.bestMove)
+                      << " Nodes: " << defaultSearchContext().nodes.load() << "\n\n";
         }
 
-        // Print best move
-        if (foundMove) {
-            std::string bestMoveStr = squareToString(bestMove.from) + squareToString(bestMove.to);
-            if (bestMove.promotion != '\0') // checks if there is promotion and adds it to the string.
-                bestMoveStr.push_back(bestMove.promotion);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "Bench: " << totalNodes << " nodes " << elapsed << " ms "
+                  << (totalNodes * 1000 / (elapsed + 1)) << " nps\n";
 
-            // Print the move for debug 
-            std::cout << "\nBest Move: " << bestMoveStr << " Evaluation: " << bestEval << "\n";
+        return std::to_string(totalNodes);
 
-            return bestMoveStr;
-        } else {
-            // No moves available
-            std::cout << "No legal moves found.\n\n";
-            return "ff";
+    }else if (command == "bench smp" || command.rfind("bench smp ", 0) == 0){
+        //////////////////////// Thread scaling: bench smp [ms], nodes per second for 1, 2, 4 .. threads ////////////////////////
+        int moveTimeMs = BENCH_SMP_MS;
+        try {
+            if (command.size() > 10) moveTimeMs = std::max(1, std::stoi(command.substr(10)));
+        } catch (...) { return "error"; }
+
+        stopSearch();
+        initEngineTables();
+
+        SearchLimits limits;
+        limits.maxDepth = MAX_SEARCH_DEPTH;
+        limits.softTimeMs = limits.moveTimeMs = moveTimeMs;
+
+        uint64_t singleNps = 0;
+        for (int threads = 1; ; threads = std::min(threads * 2, searchThreads)) {
+            uint64_t totalNodes = 0;
+            auto start = std::chrono::steady_clock::now();
+
+            for (const auto& fen : BENCH_POSITIONS) {
+                TT.clear();
+                session.searchController.resetThreads();
+                setGameHistory({});
+                setExpectedLine({});
+                session.searchController.start(parseFEN(fen), limits, searchMode, threads);
+                session.searchController.wait();
+                totalNodes += defaultSearchContext().nodes.load();
+            }
+
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            uint64_t nps = totalNodes * 1000 / (elapsed + 1);
+            if (threads == 1) singleNps = nps;
+            std::cout << "Threads: " << threads << " Nodes: " << totalNodes << " NPS: " << nps
+                      << " Speedup: " << (singleNps ? double(nps) / singleNps : 0.0) << "\n";
+
+            if (threads >= searchThreads) break;
         }
+        return "ok";
     }
     return "invalid command";
 }
\ No newline at end of file
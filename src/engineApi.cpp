@@ -0,0 +1,107 @@
+// engineApi.cpp - Engine instances on their own search context
+
+#include "engineApi.h"
+#include "engine.h"
+#include "movegen.h"
+#include "parsing.h"
+#include "updateBoard.h"
+#include "zobrist.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+Engine::Engine(size_t hashMb, int numThreads, SearchMode mode)
+    : table(std::make_unique<TranspositionTable>(hashMb)),
+      controller(context),
+      numThreads(std::max(1, numThreads)),
+      mode(mode) {
+    initEngineTables();
+    context.tt = table.get();
+    setPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+}
+
+Engine::~Engine() {
+    finishSearch();
+}
+
+// Stops a running search and waits for it, the context may be changed afterwards
+void Engine::finishSearch() {
+    controller.stop();
+    controller.wait();
+}
+
+bool Engine::setPosition(const std::string& fen, const std::vector<std::string>& moves) {
+    BoardState board;
+    try {
+        board = parseFEN(fen);
+    } catch (const std::exception&) {
+        return false; // malformed or truncated FEN
+    }
+    if (__builtin_popcountll(board.whiteKing) != 1 || __builtin_popcountll(board.blackKing) != 1 ||
+        !isLegalMoveState(board))
+        return false;
+
+    std::vector<uint64_t> keys;
+    for (const std::string& text : moves) {
+        MoveList legal = generateLegalMoves(board);
+        auto it = std::find_if(legal.moves.begin(), legal.moves.end(),
+                               [&](const Move& m) { return moveToString(m) == text; });
+        if (it == legal.moves.end())
+            return false;
+
+        keys.push_back(computeZobristKey(board));
+        updateGameState(board, *it);
+        applyMove(board, *it);
+    }
+
+    // Positions before the last irreversible move cannot repeat
+    size_t reversible = static_cast<size_t>(std::max(0, board.halfmoveClock));
+    if (keys.size() > reversible)
+        keys.erase(keys.begin(), keys.end() - reversible);
+
+    root = board;
+    history = keys;
+    return true;
+}
+
+void Engine::search(const SearchLimits& limits, Callback onDone) {
+    finishSearch();
+    context.gameHistory = history;
+    context.expectedLine.clear();
+    controller.start(root, limits, mode, numThreads, onDone);
+}
+
+void Engine::stop() {
+    controller.stop();
+}
+
+SearchResult Engine::wait() {
+    return controller.wait();
+}
+
+void Engine::newGame() {
+    finishSearch();
+    controller.resetThreads();
+    table->clear();
+}
+
+void Engine::setThreads(int threads) {
+    finishSearch();
+    numThreads = std::max(1, threads);
+}
+
+void Engine::setMode(SearchMode searchMode) {
+    finishSearch();
+    mode = searchMode;
+}
+
+bool Engine::setHash(size_t hashMb) {
+    finishSearch();
+    return table->resize(hashMb);
+}
+
+void Engine::setInfoStream(std::ostream& out) {
+    finishSearch();
+    context.info = &out;
+}
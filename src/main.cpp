@@ -212,9 +212,52 @@ void handleCastlingForKing(std::vector<Piece>& pieces, int kingIndex,
 // --------------------------------------------------
 int main() {
     std::string mode;
-    std::cout << "Enter mode (1: Engine Test, 2: GUI, 3: self-play): ";
+    std::cout << "Enter mode (1: Engine Test, 2: GUI, 3: self-play, 4: bench, 5: mate solver, 6: cluster worker, 7: cluster compare): ";
     std::getline(std::cin, mode);
 
+    // Search configuration (engine modes only)
+    if (mode != "1") {
+        BoardState unused{};
+        std::cout << "Search threads (leave empty for all cores): ";
+        std::string threadsInput;
+        std::getline(std::cin, threadsInput);
+        if (!threadsInput.empty()) engine("threads " + threadsInput, "", unused);
+
+        std::cout << "Parallel search (0: Lazy SMP, 1: root split, 2: YBWC, 3: MCTS). Default 0: ";
+        std::string parallelInput;
+        std::getline(std::cin, parallelInput);
+        if (parallelInput == "1") engine("mode rootsplit", "", unused);
+        else if (parallelInput == "2") engine("mode ybwc", "", unused);
+        else if (parallelInput == "3") engine("mode mcts", "", unused);
+    }
+
+    if (mode == "4") {
+        BoardState unused{};
+        std::string r = engine("bench", "", unused);
+        std::cout << "Engine returned: " << r << std::endl;
+        return 0;
+    }
+
+    // Cluster: workers connect to the coordinator, which compares them against a single worker
+    if (mode == "6") {
+        BoardState unused{};
+        std::cout << "Coordinator (host port). Default localhost 5555: ";
+        std::string address;
+        std::getline(std::cin, address);
+        if (address.empty()) address = "localhost 5555";
+        std::string r = engine("worker " + address, "", unused);
+        std::cout << "Engine returned: " << r << std::endl;
+        return 0;
+    }
+    if (mode == "7") {
+        BoardState unused{};
+        std::cout << "Port and number of workers. Default 5555 2: ";
+        std::string listenInput;
+        std::getline(std::cin, listenInput);
+        if (listenInput.empty()) listenInput = "5555 2";
+        if (engine("cluster listen " + listenInput, "", unused) != "ok") return 1;
+    }
+
     // Get initial FEN and setup board
     std::cout << "Enter initial FEN (or leave empty for standard start): ";
     std::string fenInput;
@@ -229,6 +272,19 @@ int main() {
         return 0;
     }
 
+    if (mode == "5") {
+        std::string r = engine("mate", fenInput, boardState);
+        std::cout << "Engine returned: " << r << std::endl;
+        return 0;
+    }
+
+    if (mode == "7") {
+        std::string r = engine("cluster compare", fenInput, boardState);
+        engine("cluster quit", "", boardState);
+        std::cout << "Engine returned: " << r << std::endl;
+        return 0;
+    }
+
     int playerChoice = 0;
     std::cout << "Play as (0=White, 1=Black). Default 0: ";
     std::string input;
@@ -238,6 +294,31 @@ int main() {
         if (playerChoice != 0 && playerChoice != 1) playerChoice = 0;
     }
 
+    // Pondering only pays off against a human, in self-play the engine answers its own moves
+    if (mode == "2") {
+        std::cout << "Ponder on your time (y/N): ";
+        std::string ponderInput;
+        std::getline(std::cin, ponderInput);
+        BoardState unused{};
+        if (ponderInput == "y" || ponderInput == "Y") engine("ponder on", "", unused);
+    }
+
+    // Game clock, charged after every move; without one the engine takes a fixed time per move
+    std::cout << "Time control (minutes+increment seconds, e.g. 5+3). Leave empty for 2 s per move: ";
+    std::string clockInput;
+    std::getline(std::cin, clockInput);
+    bool useClock = false;
+    int clockMs[2] = {0, 0}; // [0] = white, [1] = black
+    int incrementMs = 0;
+    if (!clockInput.empty()) {
+        try {
+            size_t plus = clockInput.find('+');
+            clockMs[0] = clockMs[1] = static_cast<int>(std::stod(clockInput.substr(0, plus)) * 60000);
+            if (plus != std::string::npos) incrementMs = static_cast<int>(std::stod(clockInput.substr(plus + 1)) * 1000);
+            useClock = clockMs[0] > 0;
+        } catch (...) { useClock = false; }
+    }
+
     // Initialize SFML window
     sf::RenderWindow window(sf::VideoMode(SQUARE_SIZE * BOARD_SIZE, SQUARE_SIZE * BOARD_SIZE), "Chess GUI");
 
@@ -261,6 +342,14 @@ int main() {
     Piece* selectedPiece = nullptr;
     int selectedIndex = -1;
 
+    sf::Clock turnClock;
+    auto chargeClock = [&](bool whiteMoved) {
+        if (!useClock) return;
+        int side = whiteMoved ? 0 : 1;
+        clockMs[side] += incrementMs - turnClock.restart().asMilliseconds();
+        std::cout << "Clock: white " << clockMs[0] / 1000.0 << " s, black " << clockMs[1] / 1000.0 << " s\n";
+    };
+
     while (window.isOpen()) {
         sf::Event event;
         bool humanMovedThisFrame = false;
@@ -283,7 +372,7 @@ int main() {
                 BoardState tempBoard = board;
 
                 // Generate moves for the player to prevent illegal moves
-                initAttackTables();
+                initEngineTables();
                 MoveList legalMoves = generateLegalMoves(tempBoard);
 
                 // Check if player has lost
@@ -379,7 +468,10 @@ int main() {
             }
         }
 
-        if (humanMovedThisFrame) std::cout << "Human Move: " << lastUciMove << "\n";
+        if (humanMovedThisFrame) {
+            std::cout << "Human Move: " << lastUciMove << "\n";
+            chargeClock(!board.whiteToMove);
+        }
 
         // --------------------------------------------------
         // Engine turn
@@ -389,6 +481,11 @@ int main() {
         else engineTurn = !((playerChoice == 0 && board.whiteToMove) || (playerChoice == 1 && !board.whiteToMove));
         if (engineTurn) {
             std::string fenNow = bitboardsToFEN(board);
+            if (useClock) {
+                BoardState unused{};
+                engine("clock wtime " + std::to_string(std::max(1, clockMs[0])) + " btime " + std::to_string(std::max(1, clockMs[1])) +
+                       " winc " + std::to_string(incrementMs) + " binc " + std::to_string(incrementMs), "", unused);
+            }
             std::string engineMoveUCI = engine("2", fenNow, board);
 
             if (!engineMoveUCI.empty() && engineMoveUCI.size() >= 4 && engineMoveUCI != "ff" && engineMoveUCI != "invalid command" && engineMoveUCI != "error") {
@@ -403,6 +500,7 @@ int main() {
                     // Apply move to board state
                     updateEnPassantSquare(board, mv);
                     applyMove(board, mv);
+                    chargeClock(!board.whiteToMove);
 
                     sf::Vector2i fromRC = squareIndexToRowCol(mv.from);
                     int idx = findPieceAt(pieces, fromRC.x, fromRC.y);
@@ -0,0 +1,400 @@
+// mcts.cpp - Monte Carlo Tree Search with PUCT selection (AlphaZero style, without a network).
+// Move priors come from a capture/promotion heuristic and leaves are scored by the quiescence
+// search. All threads grow one tree: nodes are bump-allocated from a fixed arena without locks,
+// and a thread walking down adds a virtual loss to every node on its path so the other threads
+// spread out over different lines instead of all expanding the same leaf.
+
+#include "mcts.h"
+#include "see.h"
+#include "updateBoard.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+
+// ============================================================================
+//  SECTION 1: NODE ARENA
+// ============================================================================
+
+enum NodeState : uint8_t { UNEXPANDED, EXPANDING, EXPANDED, TERMINAL };
+
+// Playout values are kept as fixed-point integers so they can be summed with fetch_add
+constexpr int64_t VALUE_UNIT = 1 << 16;
+
+/**
+ * A position in the tree. Its statistics are seen from the side that played @move into it.
+ * The children of a node are one contiguous block of the arena.
+ */
+struct MctsNode {
+    Move move{};
+    float prior = 0.0f;
+    float terminalValue = 0.0f;              // TERMINAL only: result for the side to move
+    std::atomic<int32_t> visits{0};
+    std::atomic<int32_t> virtualLoss{0};
+    std::atomic<int64_t> valueSum{0};        // sum of playout values, VALUE_UNIT per win
+    std::atomic<uint32_t> firstChild{0};     // valid once state is EXPANDED
+    std::atomic<uint32_t> numChildren{0};
+    std::atomic<uint8_t> state{UNEXPANDED};
+};
+
+/**
+ * @brief Fixed block of nodes handed out by an atomic bump pointer. Index 0 is never used.
+ * A context keeps its arena from search to search: reset only rewinds the pointer, and
+ * allocate clears the nodes it hands out, so a search pays for the nodes it uses only.
+ */
+class NodeArena {
+public:
+    explicit NodeArena(size_t mb)
+        : capacity(std::max<size_t>(2, mb * 1024 * 1024 / sizeof(MctsNode))),
+          nodes(new MctsNode[capacity]) {}
+
+    // Forgets every node, must not be called while a search uses the arena
+    void reset() { next.store(1, std::memory_order_relaxed); }
+
+    // First index of @count consecutive fresh nodes, 0 if the arena is full
+    uint32_t allocate(uint32_t count) {
+        size_t first = next.fetch_add(count, std::memory_order_relaxed);
+        if (first + count > capacity)
+            return 0;
+        for (size_t i = first; i < first + count; ++i)
+            clearNode(nodes[i]);
+        return static_cast<uint32_t>(first);
+    }
+
+    MctsNode& operator[](uint32_t index) { return nodes[index]; }
+    size_t used() const { return std::min(next.load(), capacity) - 1; }
+
+private:
+    size_t capacity;
+    std::unique_ptr<MctsNode[]> nodes;
+    std::atomic<size_t> next{1};
+
+    // Nodes of an earlier search are reused, back to the state of a new one
+    static void clearNode(MctsNode& node) {
+        node.move = Move{};
+        node.prior = 0.0f;
+        node.terminalValue = 0.0f;
+        node.visits.store(0, std::memory_order_relaxed);
+        node.virtualLoss.store(0, std::memory_order_relaxed);
+        node.valueSum.store(0, std::memory_order_relaxed);
+        node.firstChild.store(0, std::memory_order_relaxed);
+        node.numChildren.store(0, std::memory_order_relaxed);
+        node.state.store(UNEXPANDED, std::memory_order_relaxed);
+    }
+};
+
+
+// ============================================================================
+//  SECTION 2: PLAYOUTS
+// ============================================================================
+
+// Longest line a playout follows before it scores the position where it stands
+constexpr int MCTS_MAX_DEPTH = MAX_PLY;
+
+// Root of the tree, allocated first
+constexpr uint32_t ROOT_NODE = 1;
+
+/**
+ * leafValue - Quiescence score of the position squashed into [-1, 1] for the side to move.
+ */
+static float leafValue(BoardState& board) {
+    int cp = quiescence(board, -INF_SCORE, INF_SCORE, 0, 0);
+    return static_cast<float>(std::tanh(static_cast<double>(cp) / MCTS_VALUE_SCALE));
+}
+
+/**
+ * setPriors - Spreads the prior probability over the children: captures that win material and
+ * promotions are tried first, captures that lose material last.
+ */
+static void setPriors(NodeArena& arena, uint32_t first, const MoveList& moves, const BoardState& board) {
+    std::vector<float> weights(moves.moves.size());
+    float total = 0.0f;
+    for (size_t i = 0; i < moves.moves.size(); ++i) {
+        const Move& m = moves.moves[i];
+        float logit = 0.0f;
+        if (m.isCapture)
+            logit += staticExchange(board, m) >= 0 ? 1.0f + float(capturedValue(board, m)) / SEE_QUEEN : -0.5f;
+        if (m.promotion == 'Q' || m.promotion == 'q')
+            logit += 1.5f;
+        weights[i] = std::exp(logit);
+        total += weights[i];
+    }
+    for (size_t i = 0; i < moves.moves.size(); ++i) {
+        arena[first + i].move = moves.moves[i];
+        arena[first + i].prior = weights[i] / total;
+    }
+}
+
+/**
+ * expand - Creates the children of a node the calling thread has claimed (state EXPANDING).
+ * Returns the value of the node for its side to move.
+ */
+static float expand(NodeArena& arena, uint32_t index, BoardState& board, std::atomic<bool>& full) {
+    MctsNode& node = arena[index];
+    MoveList moves = generateLegalMoves(board);
+
+    if (moves.moves.empty()) {
+        node.terminalValue = isInCheck(board) ? -1.0f : 0.0f;
+        node.state.store(TERMINAL, std::memory_order_release);
+        return node.terminalValue;
+    }
+
+    // A full arena freezes the shape of the tree, playouts go on scoring its leaves
+    uint32_t first = full.load(std::memory_order_relaxed) ? 0 : arena.allocate(static_cast<uint32_t>(moves.moves.size()));
+    if (first == 0) {
+        full = true;
+        node.state.store(UNEXPANDED, std::memory_order_release);
+        return leafValue(board);
+    }
+
+    setPriors(arena, first, moves, board);
+    node.firstChild.store(first, std::memory_order_relaxed);
+    node.numChildren.store(static_cast<uint32_t>(moves.moves.size()), std::memory_order_relaxed);
+    node.state.store(EXPANDED, std::memory_order_release); // publishes the children
+    return leafValue(board);
+}
+
+/**
+ * selectChild - PUCT: the child maximizing Q + cpuct * P * sqrt(N) / (1 + n).
+ * Virtual losses count as lost visits; unvisited children start from the parent's value
+ * minus a small reduction (first play urgency).
+ */
+static uint32_t selectChild(NodeArena& arena, MctsNode& node) {
+    uint32_t first = node.firstChild.load(std::memory_order_relaxed);
+    uint32_t count = node.numChildren.load(std::memory_order_relaxed);
+
+    int32_t parentVisits = node.visits.load(std::memory_order_relaxed) + node.virtualLoss.load(std::memory_order_relaxed);
+    float sqrtVisits = std::sqrt(static_cast<float>(std::max(1, parentVisits)));
+    int32_t ownVisits = node.visits.load(std::memory_order_relaxed);
+    float parentValue = ownVisits > 0
+        ? -static_cast<float>(node.valueSum.load(std::memory_order_relaxed)) / VALUE_UNIT / ownVisits
+        : 0.0f;
+    float firstPlayValue = parentValue - 0.2f;
+
+    uint32_t best = first;
+    float bestScore = -1e9f;
+    for (uint32_t i = first; i < first + count; ++i) {
+        MctsNode& child = arena[i];
+        int32_t visits = child.visits.load(std::memory_order_relaxed);
+        int32_t loss = child.virtualLoss.load(std::memory_order_relaxed);
+        int32_t n = visits + loss;
+
+        float q = n > 0
+            ? (static_cast<float>(child.valueSum.load(std::memory_order_relaxed)) / VALUE_UNIT - loss) / n
+            : firstPlayValue;
+        float score = q + MCTS_CPUCT * child.prior * sqrtVisits / (1 + n);
+        if (score > bestScore) {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+/**
+ * playout - Walks from the root to a leaf, expands and scores it, and backs the value up the path.
+ * Returns the length of the path.
+ */
+static int playout(NodeArena& arena, const BoardState& root, uint64_t rootKey, std::atomic<bool>& full) {
+    uint32_t path[MCTS_MAX_DEPTH + 1];
+    uint64_t keys[MCTS_MAX_DEPTH + 1];
+    int length = 0;
+
+    BoardState board = root;
+    uint32_t index = ROOT_NODE;
+    path[length] = index;
+    keys[length++] = rootKey;
+
+    float value; // for the side to move at the end of the path
+    while (true) {
+        MctsNode& node = arena[index];
+        uint8_t state = node.state.load(std::memory_order_acquire);
+
+        if (state == TERMINAL) {
+            value = node.terminalValue;
+            break;
+        }
+        if (state == UNEXPANDED) {
+            if (node.state.compare_exchange_strong(state, EXPANDING, std::memory_order_acquire)) {
+                value = expand(arena, index, board, full);
+                break;
+            }
+        }
+        // Another thread is expanding the node, or the line is too long: score it as it is
+        if (state != EXPANDED || length > MCTS_MAX_DEPTH - 1) {
+            value = leafValue(board);
+            break;
+        }
+
+        index = selectChild(arena, node);
+        MctsNode& child = arena[index];
+        child.virtualLoss.fetch_add(MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+
+        updateGameState(board, child.move);
+        applyMove(board, child.move);
+        path[length] = index;
+        keys[length] = board.zobristKey;
+        length++;
+
+        // Repetitions along the path and the fifty-move rule are draws
+        bool repeated = false;
+        for (int i = length - 3; i >= 0 && !repeated; i -= 2)
+            repeated = (keys[i] == keys[length - 1]);
+        if (repeated || board.halfmoveClock >= 100) {
+            value = 0.0f;
+            break;
+        }
+    }
+
+    // Every node stores the value for the side that moved into it
+    for (int i = length - 1; i >= 0; --i) {
+        MctsNode& node = arena[path[i]];
+        node.valueSum.fetch_add(static_cast<int64_t>(-value * VALUE_UNIT), std::memory_order_relaxed);
+        node.visits.fetch_add(1, std::memory_order_relaxed);
+        if (i > 0)
+            node.virtualLoss.fetch_sub(MCTS_VIRTUAL_LOSS, std::memory_order_relaxed);
+        value = -value;
+    }
+    return length;
+}
+
+
+// ============================================================================
+//  SECTION 3: ROOT
+// ============================================================================
+
+// Most visited child of an expanded node, 0 if none was visited yet
+static uint32_t mostVisitedChild(NodeArena& arena, uint32_t index) {
+    if (arena[index].state.load(std::memory_order_acquire) != EXPANDED)
+        return 0;
+    uint32_t first = arena[index].firstChild.load(std::memory_order_relaxed);
+    uint32_t count = arena[index].numChildren.load(std::memory_order_relaxed);
+    uint32_t best = first;
+    for (uint32_t i = first; i < first + count; ++i)
+        if (arena[i].visits.load(std::memory_order_relaxed) > arena[best].visits.load(std::memory_order_relaxed))
+            best = i;
+    return arena[best].visits.load(std::memory_order_relaxed) > 0 ? best : 0;
+}
+
+// Line of the most visited children from the root
+static std::vector<Move> mostVisitedLine(NodeArena& arena) {
+    std::vector<Move> line;
+    for (uint32_t index = mostVisitedChild(arena, ROOT_NODE); index != 0 && line.size() < MAX_PLY;
+         index = mostVisitedChild(arena, index))
+        line.push_back(arena[index].move);
+    return line;
+}
+
+// Score of a root child in centipawns (mate scores for a child that mates)
+static int childScore(MctsNode& child) {
+    if (child.state.load(std::memory_order_acquire) == TERMINAL && child.terminalValue < 0.0f)
+        return MATE_SCORE - 1;
+    int32_t visits = std::max(1, child.visits.load(std::memory_order_relaxed));
+    double q = static_cast<double>(child.valueSum.load(std::memory_order_relaxed)) / VALUE_UNIT / visits;
+    q = std::max(-0.999, std::min(0.999, q));
+    return static_cast<int>(std::atanh(q) * MCTS_VALUE_SCALE);
+}
+
+SearchResult mctsSearch(const BoardState& board, int maxDepth, int timeLimitMs,
+                        int numThreads, ThreadPool& pool) {
+    SearchResult result;
+    SearchContext& context = searchContext();
+    auto start = std::chrono::steady_clock::now();
+
+    if (!context.mctsArena)
+        context.mctsArena = std::make_shared<NodeArena>(MCTS_ARENA_MB);
+    NodeArena& arena = *context.mctsArena;
+    arena.reset();
+    std::atomic<bool> full{false};
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> playouts{0};
+    std::atomic<int> selDepth{0};
+
+    BoardState rootBoard = keyedRoot(board);
+    uint64_t rootKey = rootBoard.zobristKey;
+    arena.allocate(1);
+    arena[ROOT_NODE].state = EXPANDING;
+    expand(arena, ROOT_NODE, rootBoard, full);
+    if (arena[ROOT_NODE].state.load() != EXPANDED)
+        return result; // no legal moves
+
+    // A stop before the first playout still answers with a legal move, the one with the highest prior
+    uint32_t firstRootChild = arena[ROOT_NODE].firstChild.load();
+    uint32_t bestPrior = firstRootChild;
+    for (uint32_t i = firstRootChild; i < firstRootChild + arena[ROOT_NODE].numChildren.load(); ++i)
+        if (arena[i].prior > arena[bestPrior].prior)
+            bestPrior = i;
+    result.found = true;
+    result.bestMove = arena[bestPrior].move;
+    result.pv = {result.bestMove};
+
+    auto searching = [&]() {
+        return !done.load(std::memory_order_relaxed) && !context.stopped.load(std::memory_order_relaxed);
+    };
+    auto onePlayout = [&]() {
+        int length = playout(arena, rootBoard, rootKey, full);
+        playouts.fetch_add(1, std::memory_order_relaxed);
+        int deepest = selDepth.load(std::memory_order_relaxed);
+        while (length > deepest && !selDepth.compare_exchange_weak(deepest, length)) {}
+    };
+    auto runPlayouts = [&]() {
+        while (searching())
+            onePlayout();
+        flushNodes();
+    };
+
+    std::vector<std::future<void>> helpers;
+    for (int i = 1; i < numThreads; ++i)
+        helpers.push_back(pool.enqueue(runPlayouts));
+
+    // The main thread watches the limits and reports while the helpers search
+    bool singleMove = arena[ROOT_NODE].numChildren.load() == 1;
+    int64_t nextReport = MCTS_REPORT_MS;
+    while (true) {
+        for (int i = 0; i < 64 && searching(); ++i)
+            onePlayout();
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::vector<Move> line = mostVisitedLine(arena);
+        uint32_t best = mostVisitedChild(arena, ROOT_NODE);
+        int score = best ? childScore(arena[best]) : 0;
+
+        // A mate in one is the most visited move only once the tree knows it, no need to go on
+        bool finished = context.stopped.load() || static_cast<int>(line.size()) >= maxDepth || score >= MATE_BOUND;
+        if (!finished && ((timeLimitMs > 0 && elapsed >= timeLimitMs) || (singleMove && timeLimitMs > 0)))
+            finished = !deferStopToPonderhit();
+
+        if (finished || elapsed >= nextReport) {
+            flushNodes();
+            nextReport = elapsed + MCTS_REPORT_MS;
+            uint64_t count = playouts.load();
+
+            if (!line.empty()) {
+                result.bestMove = line.front();
+                result.score = score;
+                result.pv = line;
+                result.depth = static_cast<int>(line.size());
+            }
+
+            *context.info << "info depth " << line.size() << " seldepth " << selDepth.load()
+                          << " score " << scoreToString(score) << " nodes " << context.nodes.load()
+                          << " playouts " << count << " pps " << (count * 1000 / (elapsed + 1))
+                          << " tree " << arena.used() << " time " << elapsed
+                          << " pv " << pvToString(line) << "\n";
+        }
+        if (finished)
+            break;
+    }
+
+    done = true;
+    for (auto& helper : helpers)
+        helper.get();
+    return result;
+}
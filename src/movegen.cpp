@@ -5,6 +5,7 @@
 #include "movegen.h"
 #include "parsing.h"
 #include "updateBoard.h"
+#include "see.h"
 
 #include <bitset>
 #include <cassert>
@@ -22,6 +23,16 @@ std::string squareToString(int sq) {
     return {file, rank};
 }
 
+/**
+ * Converts a move to its coordinate string, e.g. "e2e4" or "e7e8Q".
+ */
+std::string moveToString(const Move& move) {
+    std::string s = squareToString(move.from) + squareToString(move.to);
+    if (move.promotion != '\0')
+        s.push_back(move.promotion);
+    return s;
+}
+
 /**
  * Macros for bitboard manipulation
  * - GET_BIT(bb, sq): returns 1 if bit at `sq` is set in `bb`
@@ -160,6 +171,22 @@ uint64_t queenAttacks(int sq, uint64_t blockers) {
     return rookAttacks(sq, blockers) | bishopAttacks(sq, blockers);
 }
 
+/**
+ * Returns all pieces of both sides that attack `sq`, with sliders blocked by `occupied`.
+ * Passing an occupancy with pieces removed reveals the x-ray attackers behind them.
+ */
+uint64_t attackersTo(const BoardState& board, int sq, uint64_t occupied) {
+    uint64_t bishopsQueens = board.whiteBishops | board.blackBishops | board.whiteQueens | board.blackQueens;
+    uint64_t rooksQueens   = board.whiteRooks   | board.blackRooks   | board.whiteQueens | board.blackQueens;
+
+    return (board.whitePawns & blackPawnAttacks[sq]) |   // white pawns sit where a black pawn on sq would attack
+           (board.blackPawns & whitePawnAttacks[sq]) |
+           ((board.whiteKnights | board.blackKnights) & knightAttacks[sq]) |
+           ((board.whiteKing | board.blackKing) & kingAttacks[sq]) |
+           (bishopAttacks(sq, occupied) & bishopsQueens) |
+           (rookAttacks(sq, occupied) & rooksQueens);
+}
+
 
 // ============================================================================
 //  SECTION 4: CORE MOVE GENERATION
@@ -168,8 +195,10 @@ uint64_t queenAttacks(int sq, uint64_t blockers) {
 /*
  * Generates all attacks for the given board state.
  */
-MoveList generateMoves(const BoardState& board) {
-    MoveList result;
+void generateMoves(const BoardState& board, MoveList& result) {
+    result.moves.clear();
+    result.whiteAttacks = 0ULL;
+    result.blackAttacks = 0ULL;
 
     // ------------------------------
     // Compute useful aggregate masks
@@ -211,13 +240,14 @@ MoveList generateMoves(const BoardState& board) {
 
     /**
      * Helper to add a move to the move list.
+     * Captures go straight into the result, quiets wait in a per-thread buffer that keeps its capacity.
      */
-    std::vector<Move> captures;
-    std::vector<Move> quiets;
+    static thread_local std::vector<Move> quiets;
+    quiets.clear();
     auto addMove = [&](int from, int to, char promo, bool capture, bool ep, bool castle) {
         Move m = {from, to, promo, capture, ep, castle};
         if (capture || ep || promo != '\0')
-            captures.push_back(m);
+            result.moves.push_back(m);
         else if(!board.genVolatile)
             quiets.push_back(m);
     };
@@ -464,23 +494,20 @@ MoveList generateMoves(const BoardState& board) {
     }
 
     // Combine captures and quiet moves, captures first
-    result.moves.reserve(captures.size() + quiets.size());
-    result.moves.insert(result.moves.end(), captures.begin(), captures.end());
     result.moves.insert(result.moves.end(), quiets.begin(), quiets.end());
+}
 
+MoveList generateMoves(const BoardState& board) {
+    MoveList result;
+    generateMoves(board, result);
     return result;
 }
 
 /**
- * Function that ensures the king is not exposed to check after move generation.
+ * Returns true if the king of the given side is attacked by the other side.
+ * Both kings must be on the board.
  */
-bool isLegalMoveState(const BoardState& board) {
-     // Both kings must exist first (avoid __builtin_ctzll on zero)
-    if (board.whiteKing == 0 || board.blackKing == 0) return false;
-
-    // We need to check the side that just moved (opposite of side to move)
-    bool white = !board.whiteToMove;
-
+static bool isKingAttacked(const BoardState& board, bool white) {
     // Get that side's king square
     int kingSq = white ? __builtin_ctzll(board.whiteKing) : __builtin_ctzll(board.blackKing);
 
@@ -490,7 +517,7 @@ bool isLegalMoveState(const BoardState& board) {
                           board.blackPawns | board.blackKnights | board.blackBishops |
                           board.blackRooks | board.blackQueens | board.blackKing);
 
-    // Collect opponent pieces (the side that will move next)
+    // Collect opponent pieces (the attacking side)
     uint64_t oppPawns   = white ? board.blackPawns   : board.whitePawns;
     uint64_t oppKnights = white ? board.blackKnights : board.whiteKnights;
     uint64_t oppBishops = white ? board.blackBishops : board.whiteBishops;
@@ -520,30 +547,51 @@ bool isLegalMoveState(const BoardState& board) {
         return res;
     };
 
-    // In isLegalMoveState:
     if (white) {
-        // side that just moved is white -> check if any black pawn attacks white king
-        if (pawnAttacksTo(/*attackerIsWhite=*/false, kingSq) & oppPawns) return false;
+        // white king -> check if any black pawn attacks it
+        if (pawnAttacksTo(/*attackerIsWhite=*/false, kingSq) & oppPawns) return true;
     } else {
-        if (pawnAttacksTo(/*attackerIsWhite=*/true, kingSq) & oppPawns) return false;
+        if (pawnAttacksTo(/*attackerIsWhite=*/true, kingSq) & oppPawns) return true;
     }
 
-    if (knightAttacks[kingSq] & oppKnights) return false;
-    if (bishopAttacks(kingSq, allPieces) & (oppBishops | oppQueens)) return false;
-    if (rookAttacks(kingSq, allPieces) & (oppRooks | oppQueens)) return false;
-    if (kingAttacks[kingSq] & oppKing) return false;
+    if (knightAttacks[kingSq] & oppKnights) return true;
+    if (bishopAttacks(kingSq, allPieces) & (oppBishops | oppQueens)) return true;
+    if (rookAttacks(kingSq, allPieces) & (oppRooks | oppQueens)) return true;
+    if (kingAttacks[kingSq] & oppKing) return true;
 
-    return true;
+    return false;
 }
 
 /**
- * Move ordering function that prioritizes captures then promotions then quiet moves.
- * It also sorts captures by MVV-LVA (Most Valuable Victim - Least Valuable Attacker).
+ * Function that ensures the king is not exposed to check after move generation.
+ */
+bool isLegalMoveState(const BoardState& board) {
+     // Both kings must exist first (avoid __builtin_ctzll on zero)
+    if (board.whiteKing == 0 || board.blackKing == 0) return false;
+
+    // We need to check the side that just moved (opposite of side to move)
+    return !isKingAttacked(board, !board.whiteToMove);
+}
+
+/**
+ * Returns true if the side to move is in check.
  */
-MoveList orderMoves(const MoveList& moves, const BoardState& board) {
-    MoveList ordered;
-    ordered.moves = moves.moves; // copy moves
+bool isInCheck(const BoardState& board) {
+    if (board.whiteKing == 0 || board.blackKing == 0) return false;
+    return isKingAttacked(board, board.whiteToMove);
+}
 
+// Ordering offsets that put winning captures before and losing captures after the quiet moves
+static const int GOOD_CAPTURE_BONUS  = 100000;
+static const int BAD_CAPTURE_PENALTY = -100000;
+
+/**
+ * Move ordering function that prioritizes winning captures then promotions then quiet moves.
+ * It also sorts captures by MVV-LVA (Most Valuable Victim - Least Valuable Attacker).
+ * Captures that lose material according to the static exchange evaluation go last.
+ * Sorts in place with a stable insertion sort, move lists are short and it needs no buffer.
+ */
+static void orderMoves(std::vector<Move>& moves, const BoardState& board) {
     // Simple scoring function for MVV-LVA
     auto scoreMove = [&](const Move& move) -> int {
         int score = 0;
@@ -557,9 +605,10 @@ MoveList orderMoves(const MoveList& moves, const BoardState& board) {
                 if (GET_BIT(board.whiteQueens | board.blackQueens, sq)) return 900;
                 return 0; // king or empty
             };
-            int victimValue = pieceValue(move.to);
+            int victimValue = move.isEnPassant ? 100 : pieceValue(move.to);
             int attackerValue = pieceValue(move.from);
             score += (victimValue * 10) - attackerValue; // MVV-LVA
+            score += (staticExchange(board, move) >= 0) ? GOOD_CAPTURE_BONUS : BAD_CAPTURE_PENALTY;
         }
         if (move.promotion != '\0') {
             score += 800; // high score for promotions
@@ -567,13 +616,23 @@ MoveList orderMoves(const MoveList& moves, const BoardState& board) {
         return score;
     };
 
-    // Sort moves based on their scores
-    std::sort(ordered.moves.begin(), ordered.moves.end(),
-              [&](const Move& a, const Move& b) {
-                  return scoreMove(a) > scoreMove(b);
-              });
-
-    return ordered;
+    // Score once, then sort moves based on their scores
+    static thread_local std::vector<int> scores;
+    scores.clear();
+    for (const auto& m : moves)
+        scores.push_back(scoreMove(m));
+
+    for (size_t i = 1; i < moves.size(); ++i) {
+        Move move = moves[i];
+        int score = scores[i];
+        size_t j = i;
+        for (; j > 0 && scores[j - 1] < score; --j) {
+            moves[j] = moves[j - 1];
+            scores[j] = scores[j - 1];
+        }
+        moves[j] = move;
+        scores[j] = score;
+    }
 }
 
 
@@ -581,9 +640,13 @@ MoveList orderMoves(const MoveList& moves, const BoardState& board) {
 /**
  * Generate all legal moves for the current player.
  */
-MoveList generateLegalMoves(const BoardState& board) {
-    MoveList pseudo = generateMoves(board);
-    MoveList legal;
+void generateLegalMoves(const BoardState& board, MoveList& legal) {
+    static thread_local MoveList pseudo;
+    generateMoves(board, pseudo);
+
+    legal.moves.clear();
+    legal.whiteAttacks = pseudo.whiteAttacks;
+    legal.blackAttacks = pseudo.blackAttacks;
 
     for (auto& move : pseudo.moves) {
         BoardState newBoard = board;
@@ -595,7 +658,11 @@ MoveList generateLegalMoves(const BoardState& board) {
     }
 
     // Move ordering
-    legal = orderMoves(legal, board);
-    
+    orderMoves(legal.moves, board);
+}
+
+MoveList generateLegalMoves(const BoardState& board) {
+    MoveList legal;
+    generateLegalMoves(board, legal);
     return legal;
 }
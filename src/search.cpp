@@ -1,4 +1,4 @@
-// The file uses min-max search algorithm to determine the best move for the current player in a chess game.
+// The file uses a negamax (min-max) search algorithm to determine the best move for the current player in a chess game.
 
 #include "search.h"
 #include "movegen.h"
@@ -7,52 +7,358 @@
 #include "updateBoard.h"
 #include "zobrist.h"
 #include "transposition.h"
+#include "threadPool.h"
+#include "ybwc.h"
+#include "see.h"
+#include "timeManager.h"
 
 #include <vector>
 #include <limits>
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <atomic>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cassert>
 
 
 // ============================================================================
-//  SECTION 1: MIN-MAX SEARCH ALGORITHM
+//  SECTION 1: NEGAMAX SEARCH ALGORITHM
 // ============================================================================
 
+// Context of the engine() command interface, searching with the global TT
+static SearchContext defaultContext;
+
+// Context the calling thread searches for
+static thread_local SearchContext* boundContext = &defaultContext;
+
+SearchContext& defaultSearchContext() {
+    return defaultContext;
+}
+
+SearchContext& searchContext() {
+    return *boundContext;
+}
+
+void bindSearchContext(SearchContext* context) {
+    boundContext = context ? context : &defaultContext;
+}
+
+static int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void prepareSearch(SearchContext& context, const SearchLimits& limits) {
+    context.stopped = false;
+    context.nodes = 0;
+    context.nodeLimit = limits.maxNodes;
+    context.deadlineMs = (limits.moveTimeMs > 0) ? nowMs() + limits.moveTimeMs : 0;
+    context.stopOnPonderhit = false;
+    context.pondering = limits.ponder;
+}
+
+void ponderHit(SearchContext& context) {
+    context.pondering = false;
+    if (context.stopOnPonderhit.load())
+        context.stopped = true;
+}
+
+// True while pondering: the time manager's stop is put off until the ponderhit
+bool deferStopToPonderhit() {
+    SearchContext& context = *boundContext;
+    if (!context.pondering.load(std::memory_order_relaxed))
+        return false;
+    context.stopOnPonderhit = true;
+    return true;
+}
+
+// Per-thread node count, added to the context's count in batches so threads do not share a cache line per node
+static thread_local uint64_t localNodes = 0;
+static constexpr uint64_t NODE_BATCH = 1024;
+
+// Stops the search once the node limit or the deadline is reached, polled once per node batch
+static void checkSearchLimits() {
+    SearchContext& context = *boundContext;
+    uint64_t maxNodes = context.nodeLimit.load(std::memory_order_relaxed);
+    int64_t deadline = context.deadlineMs.load(std::memory_order_relaxed);
+
+    if (context.pondering.load(std::memory_order_relaxed))
+        return;
+
+    if ((maxNodes && context.nodes.load(std::memory_order_relaxed) >= maxNodes) ||
+        (deadline && nowMs() >= deadline))
+        context.stopped.store(true, std::memory_order_relaxed);
+}
+
+static inline void countNode() {
+    if (++localNodes >= NODE_BATCH) {
+        boundContext->nodes.fetch_add(localNodes, std::memory_order_relaxed);
+        localNodes = 0;
+        checkSearchLimits();
+    }
+}
+
+// True if the calling thread's search was stopped
+static inline bool searchStopped() {
+    return boundContext->stopped.load(std::memory_order_relaxed);
+}
+
+// True if the current search was stopped or a YBWC split point above this thread failed high
+static inline bool searchAborted() {
+    return searchStopped() || ybwcAborted();
+}
+
+// Adds the nodes of the calling thread that are not yet part of its context's count
+void flushNodes() {
+    boundContext->nodes.fetch_add(localNodes, std::memory_order_relaxed);
+    localNodes = 0;
+}
+
+// Score of a drawn position
+constexpr int DRAW_SCORE = 0;
+
+// Static eval of a frame whose node did not need one (PV nodes, in check)
+constexpr int NO_EVAL = -INF_SCORE - 1;
+
+// More moves than any legal position has (218)
+constexpr int MAX_MOVES = 256;
+
+/**
+ * One ply of a search thread's current line. Every node at that ply reuses the frame,
+ * so a node neither allocates nor rebuilds the context of the nodes above it.
+ */
+struct alignas(64) SearchFrame {
+    BoardState board;           // position of the ply, written by the parent before it recurses
+    uint64_t key = 0;           // Zobrist key of the position, for repetition detection
+    bool inCheck = false;
+    int staticEval = NO_EVAL;
+    MoveList moves;             // legal moves of the node, keeps its capacity from node to node
+    int quietScores[MAX_MOVES]; // ordering scores of the quiet moves, sorted along with them
+    Move quietsTried[64];       // quiet moves searched without a cutoff
+    int quietsTriedCount = 0;
+    Move currentMove{};         // move searched from this ply
+    int currentPiece = -1;      // zobrist piece index of currentMove, -1 for none (root or null move)
+    Move killers[2] = {};       // two quiet cutoff moves
+    Move pv[MAX_PLY];           // triangular PV table: best line found from this ply on
+    int pvLength = 0;
+};
+
+// Frames 0..MAX_PLY: a node at the deepest ply, MAX_PLY - 1, still writes its child's board
+struct SearchStack {
+    SearchFrame frames[MAX_PLY + 1];
+
+    SearchFrame& operator[](int ply) { return frames[ply]; }
+};
+
+static thread_local SearchStack stack;
+
+void setGameHistory(const std::vector<uint64_t>& keys) {
+    boundContext->gameHistory = keys;
+}
+
+const SearchStack* searchStack() {
+    return &stack;
+}
+
+void loadSearchPath(const SearchStack* from, int plies) {
+    for (int p = 0; p < std::min(plies, MAX_PLY); ++p)
+        stack[p].key = from->frames[p].key;
+}
+
+// Static evaluation of the node, taken from its TT entry when that has one
+static inline int staticEvalOf(const BoardState& board, bool ttHit, const TTEntry& ttEntry) {
+    if (ttHit && ttEntry.eval != TT_EVAL_NONE)
+        return ttEntry.eval;
+    return evaluateBoard(board);
+}
+
+// Score for the search output: "cp <n>" or "mate <moves>", negative if the side to move gets mated
+std::string scoreToString(int score) {
+    if (score >= MATE_BOUND)
+        return "mate " + std::to_string((MATE_SCORE - score + 1) / 2);
+    if (score <= -MATE_BOUND)
+        return "mate -" + std::to_string((MATE_SCORE + score) / 2);
+    return "cp " + std::to_string(score);
+}
+
+BoardState keyedRoot(const BoardState& board) {
+    BoardState root = board;
+    root.zobristKey = computeZobristKey(board);
+    return root;
+}
+
+/**
+ * isRepetition - Checks whether the position at @ply repeats an earlier one.
+ * @key: Zobrist key of the position.
+ * @ply: Distance from the root, the frames 0..ply-1 hold the line leading to it.
+ * @halfmoveClock: Plies since the last capture or pawn move, nothing older can repeat.
+ * Only every second ply has the same side to move, and a repetition needs at least four plies.
+ * A repetition inside the search tree is scored as a draw straight away (twofold); one that
+ * reaches into the game history needs a second earlier occurrence (threefold).
+ */
+static bool isRepetition(uint64_t key, int ply, int halfmoveClock) {
+    const std::vector<uint64_t>& gameHistory = boundContext->gameHistory;
+    int gameRepeats = 0;
+    for (int back = 4; back <= halfmoveClock; back += 2) {
+        int p = ply - back;
+        if (p >= 0) {
+            if (stack[p].key == key)
+                return true;
+        } else {
+            int index = static_cast<int>(gameHistory.size()) + p;
+            if (index < 0)
+                break;
+            if (gameHistory[index] == key && ++gameRepeats >= 2)
+                return true;
+        }
+    }
+    return false;
+}
+
+static inline bool isQuiet(const Move& move) {
+    return !move.isCapture && move.promotion == '\0';
+}
+
+static inline bool sameMove(const Move& a, const Move& b) {
+    return a.from == b.from && a.to == b.to && a.promotion == b.promotion;
+}
+
+// Safety margin on top of the captured piece's value for delta pruning in quiescence
+constexpr int DELTA_MARGIN = 200;
+
+// TT depths of quiescence results, below any full-width search
+constexpr int QS_DEPTH_CHECKS = 0;     // first quiescence ply, quiet checks included
+constexpr int QS_DEPTH_CAPTURES = -1;  // deeper plies, captures and evasions only
+
 /**
  * quiescence - Extends the search at leaf nodes to avoid horizon effect.
  * @board: Current state of the chess board.
  * @alpha: Alpha value for alpha-beta pruning.
  * @beta: Beta value for alpha-beta pruning.
- * The function explores only capture moves to stabilize the evaluation.
+ * @ply: Distance from the root.
+ * @depth: QS_DEPTH_CHECKS at the first quiescence ply, lower below it.
+ * The function explores only capture moves to stabilize the evaluation,
+ * skipping captures that lose material (SEE) or cannot reach alpha (delta pruning).
+ * At the first ply it also tries quiet checks (see SearchOptions). In check it cannot
+ * stand pat and searches every evasion instead, so a mate is found as such.
+ * Results go to the TT at depth QS_DEPTH_CHECKS or QS_DEPTH_CAPTURES.
+ * Fail-soft: the returned score may lie outside [alpha, beta].
  */
-int quiescence(BoardState& board, int alpha, int beta) {
-    int stand_pat = evaluateBoard(board);
-
-    // Alpha-beta pruning check
-    if (stand_pat >= beta)
-        return beta;
-    if (alpha < stand_pat)
-        alpha = stand_pat;
-
-    // Generate only capture moves (to extend tactical lines)
-    board.genVolatile = true;
-    MoveList captureMoves = generateLegalMoves(board);
+int quiescence(BoardState& board, int alpha, int beta, int ply, int depth) {
+    countNode();
+    SearchFrame& frame = stack[ply];
+
+    if (ply >= MAX_PLY - 1)
+        return evaluateBoard(board);
+
+    // Kept incrementally by updateGameState / applyMove
+    uint64_t key = board.zobristKey;
+    assert(key == computeZobristKey(board));
+    frame.key = key;
+    frame.inCheck = isInCheck(board);
+    depth = std::max(depth, QS_DEPTH_CAPTURES);
+
+    TTEntry ttEntry;
+    bool ttHit = boundContext->tt->probe(key, ttEntry);
+    if (ttHit && ttEntry.depth >= depth) {
+        int ttScore = scoreFromTT(ttEntry.score, ply);
+        if (ttEntry.flag == EXACT)
+            return ttScore;
+        if (ttEntry.flag == LOWERBOUND && ttScore >= beta)
+            return ttScore;
+        if (ttEntry.flag == UPPERBOUND && ttScore <= alpha)
+            return ttScore;
+    }
+
+    int originalAlpha = alpha;
+    auto storeResult = [&](int score, const Move& best) {
+        TTEntry storeEntry;
+        storeEntry.key = key;
+        storeEntry.depth = depth;
+        storeEntry.score = scoreToTT(score, ply);
+        storeEntry.flag = (score >= beta) ? LOWERBOUND : (score > originalAlpha) ? EXACT : UPPERBOUND;
+        storeEntry.bestMove = best;
+        storeEntry.eval = frame.inCheck ? TT_EVAL_NONE : frame.staticEval;
+        boundContext->tt->store(storeEntry);
+    };
+
+    // Alpha-beta pruning check, only a side that is not in check may decline to capture
+    int stand_pat = frame.inCheck ? -INF_SCORE : staticEvalOf(board, ttHit, ttEntry);
+    frame.staticEval = frame.inCheck ? NO_EVAL : stand_pat;
+    int bestScore = stand_pat;
+    if (bestScore >= beta) {
+        storeResult(bestScore, Move{});
+        return bestScore;
+    }
+    if (alpha < bestScore)
+        alpha = bestScore;
+
+    // Generate only capture moves (to extend tactical lines), every move against a check
+    // and, at the first ply, quiet moves that are filtered down to checks below
+    bool tryChecks = !frame.inCheck && depth >= QS_DEPTH_CHECKS && boundContext->options.quiescenceChecks;
+    MoveList& captureMoves = frame.moves;
+    board.genVolatile = !frame.inCheck && !tryChecks;
+    generateLegalMoves(board, captureMoves);
     board.genVolatile = false;
 
+    // Checkmated: no evasion left
+    if (frame.inCheck && captureMoves.moves.empty())
+        return -MATE_SCORE + ply;
+
+    // Search the transposition table move first
+    if (ttHit && ttEntry.bestMove.from != ttEntry.bestMove.to) {
+        for (size_t i = 1; i < captureMoves.moves.size(); ++i) {
+            if (sameMove(captureMoves.moves[i], ttEntry.bestMove)) {
+                std::rotate(captureMoves.moves.begin(), captureMoves.moves.begin() + i,
+                            captureMoves.moves.begin() + i + 1);
+                break;
+            }
+        }
+    }
+
+    Move bestMoveLocal{};
     for (const auto& move : captureMoves.moves) {
-        BoardState newBoard = board;
+        bool quiet = isQuiet(move);
+        if (!frame.inCheck && !quiet && move.promotion == '\0') {
+            // Delta pruning: even winning the victim for free cannot lift the score to alpha
+            if (stand_pat + capturedValue(board, move) + DELTA_MARGIN <= alpha)
+                continue;
+            // Captures that lose material in the exchange are not worth resolving
+            if (staticExchange(board, move) < 0)
+                continue;
+        }
+        // A quiet check that simply loses the checking piece resolves nothing
+        if (tryChecks && quiet && staticExchange(board, move) < 0)
+            continue;
+
+        BoardState& newBoard = stack[ply + 1].board;
+        newBoard = board;
 
         updateGameState(newBoard, move);
         applyMove(newBoard, move);
+        boundContext->tt->prefetch(newBoard.zobristKey);
+
+        if (tryChecks && quiet && !isInCheck(newBoard))
+            continue;
 
-        int score = -quiescence(newBoard, -beta, -alpha); // negamax-style symmetry
+        int score = -quiescence(newBoard, -beta, -alpha, ply + 1, depth - 1); // negamax-style symmetry
 
-        if (score >= beta)
-            return beta;
-        if (score > alpha)
-            alpha = score;
+        if (score > bestScore) {
+            bestScore = score;
+            bestMoveLocal = move;
+            if (score > alpha)
+                alpha = score;
+            if (alpha >= beta)
+                break;
+        }
     }
 
-    return alpha;
+    storeResult(bestScore, bestMoveLocal);
+    return bestScore;
 }
 
 // int quiescence(BoardState& board, int alpha, int beta, bool isMaximizingPlayer) {
@@ -86,120 +392,512 @@ int quiescence(BoardState& board, int alpha, int beta) {
 // }
 
 
+// ============================================================================
+//  SELECTIVE SEARCH PARAMETERS
+// ============================================================================
+
+constexpr int RFP_MAX_DEPTH = 3;          // reverse futility pruning up to this depth
+constexpr int RFP_MARGIN = 120;           // per ply of depth
+constexpr int RAZOR_MAX_DEPTH = 2;        // razoring up to this depth
+constexpr int RAZOR_MARGIN = 300;         // per ply of depth
+constexpr int NULL_MIN_DEPTH = 3;         // null move pruning from this depth
+constexpr int NULL_REDUCTION = 2;         // base reduction R, grows by one every 6 plies
+constexpr int NULL_VERIFY_DEPTH = 8;      // from this depth a null move cutoff is verified
+constexpr int FUTILITY_MAX_DEPTH = 2;     // futility pruning up to this depth
+constexpr int FUTILITY_MARGIN = 150;      // per ply of depth
+constexpr int LMP_MAX_DEPTH = 3;          // late move pruning up to this depth
+constexpr int LMP_BASE = 4;               // quiet moves kept at depth d: LMP_BASE + 2 * d * d
+constexpr int LMR_MIN_DEPTH = 3;          // late move reductions from this depth
+constexpr int LMR_MIN_MOVES = 3;          // ... and from this move number
+constexpr int LMR_HISTORY_DIVISOR = 8192; // history score worth one ply of reduction
+
+// Late move reduction by [depth][move number]
+static int lmrReduction(int depth, int moveNumber) {
+    static const auto table = []() {
+        std::array<std::array<int, 64>, 64> t{};
+        for (int d = 1; d < 64; ++d)
+            for (int m = 1; m < 64; ++m)
+                t[d][m] = static_cast<int>(0.75 + std::log(d) * std::log(m) / 2.25);
+        return t;
+    }();
+    return table[std::min(depth, 63)][std::min(moveNumber, 63)];
+}
+
+// Zugzwang guard: null moves are only tried with pieces other than pawns and king
+static bool hasNonPawnMaterial(const BoardState& board) {
+    if (board.whiteToMove)
+        return (board.whiteKnights | board.whiteBishops | board.whiteRooks | board.whiteQueens) != 0;
+    return (board.blackKnights | board.blackBishops | board.blackRooks | board.blackQueens) != 0;
+}
+
+
+// ============================================================================
+//  QUIET MOVE ORDERING HEURISTICS
+// ============================================================================
+
+constexpr int HISTORY_MAX = 16384;        // history entries stay within +-HISTORY_MAX (gravity)
+constexpr int HISTORY_BONUS_MAX = 1600;   // largest history change of a single cutoff
+constexpr int KILLER_1_SCORE = 1000000;   // ordering scores, above any history sum
+constexpr int KILLER_2_SCORE = 900000;
+constexpr int COUNTER_SCORE = 800000;
+
+// All tables are per thread, every search thread learns from its own cutoffs
+// (killers and the move context of countermoves and continuation history are in the frames)
+static thread_local int quietHistory[2][64][64];               // butterfly history [side][from][to]
+static thread_local Move counterMoves[12][64];                 // reply to [previous piece][previous to]
+static thread_local int16_t continuationHistory[12][64][12][64]; // [previous piece][to][piece][to]
+
+// Zobrist piece index (0..11, white first) of the piece on sq, -1 if empty
+static int pieceOn(const BoardState& board, int sq) {
+    const uint64_t pieces[12] = {
+        board.whitePawns, board.whiteKnights, board.whiteBishops,
+        board.whiteRooks, board.whiteQueens, board.whiteKing,
+        board.blackPawns, board.blackKnights, board.blackBishops,
+        board.blackRooks, board.blackQueens, board.blackKing
+    };
+    for (int p = 0; p < 12; ++p)
+        if (GET_BIT(pieces[p], sq)) return p;
+    return -1;
+}
+
+void recordPlyMove(int ply, const BoardState& board, const Move& move) {
+    if (ply < MAX_PLY) {
+        stack[ply].currentMove = move;
+        stack[ply].currentPiece = pieceOn(board, move.from);
+    }
+}
+
+// Principal variation of the previous iteration, searched first as long as the line follows it
+static thread_local std::vector<Move> previousPv;
+static thread_local bool followPv = false;
+
+void resetPlyMoves() {
+    for (auto& frame : stack.frames)
+        frame.currentPiece = -1;
+    followPv = false;
+}
+
+void updatePv(int ply, const Move& move) {
+    SearchFrame& frame = stack[ply];
+    const SearchFrame& child = stack[ply + 1];
+    int childLength = (ply + 1 < MAX_PLY) ? child.pvLength : 0;
+    frame.pv[0] = move;
+    std::copy(child.pv, child.pv + childLength, frame.pv + 1);
+    frame.pvLength = childLength + 1;
+}
+
+void getPv(int ply, PvLine& line) {
+    line.length = stack[ply].pvLength;
+    std::copy(stack[ply].pv, stack[ply].pv + line.length, line.moves);
+}
+
+void setPv(int ply, const PvLine& line) {
+    SearchFrame& frame = stack[ply];
+    frame.pvLength = std::min(line.length, MAX_PLY - ply);
+    std::copy(line.moves, line.moves + frame.pvLength, frame.pv);
+}
+
+// Lets the next search from the root try the moves of pv first (empty: no PV to follow)
+static void followPreviousPv(const std::vector<Move>& pv) {
+    previousPv = pv;
+    followPv = !pv.empty();
+}
+
+void setExpectedLine(const std::vector<Move>& line) {
+    boundContext->expectedLine = line;
+}
+
+// Moves the first move of the expected line to the front of the root moves.
+// Returns the line for the first iteration to follow, empty if it does not fit the root.
+static std::vector<Move> followExpectedLine(std::vector<Move>& rootMoves) {
+    const std::vector<Move>& expectedLine = boundContext->expectedLine;
+    if (expectedLine.empty())
+        return {};
+    auto it = std::find_if(rootMoves.begin(), rootMoves.end(),
+                           [&](const Move& m) { return sameMove(m, expectedLine.front()); });
+    if (it == rootMoves.end())
+        return {};
+    std::rotate(rootMoves.begin(), it, it + 1);
+    return expectedLine;
+}
+
+// Principal variation from the root on the calling thread
+static std::vector<Move> rootPv() {
+    return std::vector<Move>(stack[0].pv, stack[0].pv + stack[0].pvLength);
+}
+
 /**
- * minimax - Implements the Min-Max algorithm with Alpha-Beta pruning and transposition tables to evaluate the best move.
+ * extendPvFromTT - A TT cutoff ends the principal variation early: continues @pv from @root
+ * with the TT best moves of the positions after it, until a position has no legal TT move,
+ * repeats one of the line or the line reaches MAX_PLY moves.
+ */
+static void extendPvFromTT(const BoardState& root, std::vector<Move>& pv) {
+    BoardState board = keyedRoot(root);
+    std::vector<uint64_t> seen = {board.zobristKey};
+    for (const Move& m : pv) {
+        updateGameState(board, m);
+        applyMove(board, m);
+        seen.push_back(board.zobristKey);
+    }
+
+    TTEntry ttEntry;
+    while (static_cast<int>(pv.size()) < MAX_PLY && boundContext->tt->probe(board.zobristKey, ttEntry)) {
+        MoveList legal = generateLegalMoves(board);
+        auto it = std::find_if(legal.moves.begin(), legal.moves.end(),
+                               [&](const Move& m) { return sameMove(m, ttEntry.bestMove); });
+        if (it == legal.moves.end())
+            break;
+
+        updateGameState(board, *it);
+        applyMove(board, *it);
+        if (std::find(seen.begin(), seen.end(), board.zobristKey) != seen.end())
+            break;
+        seen.push_back(board.zobristKey);
+        pv.push_back(*it);
+    }
+}
+
+std::string pvToString(const std::vector<Move>& pv) {
+    std::string line;
+    for (const Move& m : pv)
+        line += (line.empty() ? "" : " ") + moveToString(m);
+    return line;
+}
+
+// History gravity: entries move towards +-HISTORY_MAX ever slower, old results fade out
+template <typename T>
+static inline void updateHistory(T& entry, int bonus) {
+    int value = entry;
+    value += bonus - value * std::abs(bonus) / HISTORY_MAX;
+    entry = static_cast<T>(value);
+}
+
+// Ordering score of a quiet move: killers, then countermove, then history sums
+static int quietScore(const BoardState& board, const Move& move, int ply) {
+    if (sameMove(move, stack[ply].killers[0])) return KILLER_1_SCORE;
+    if (sameMove(move, stack[ply].killers[1])) return KILLER_2_SCORE;
+
+    const SearchFrame* prev1 = (ply >= 1 && stack[ply - 1].currentPiece >= 0) ? &stack[ply - 1] : nullptr;
+    const SearchFrame* prev2 = (ply >= 2 && stack[ply - 2].currentPiece >= 0) ? &stack[ply - 2] : nullptr;
+
+    if (prev1 && sameMove(move, counterMoves[prev1->currentPiece][prev1->currentMove.to])) return COUNTER_SCORE;
+
+    int piece = pieceOn(board, move.from);
+    int score = quietHistory[board.whiteToMove ? 0 : 1][move.from][move.to];
+    if (prev1) score += continuationHistory[prev1->currentPiece][prev1->currentMove.to][piece][move.to];
+    if (prev2) score += continuationHistory[prev2->currentPiece][prev2->currentMove.to][piece][move.to];
+    return score;
+}
+
+// Sorts the quiet moves, which sit between the winning and the losing captures, by quietScore.
+// Stable insertion sort in place, the scores live in the ply's frame: no allocation per node.
+static void orderQuietMoves(const BoardState& board, std::vector<Move>& moves, int ply) {
+    auto firstQuiet = std::find_if(moves.begin(), moves.end(), isQuiet);
+    auto lastQuiet = std::find_if_not(firstQuiet, moves.end(), isQuiet);
+    Move* quiets = moves.data() + (firstQuiet - moves.begin());
+    int count = std::min<int>(static_cast<int>(lastQuiet - firstQuiet), MAX_MOVES);
+    int* scores = stack[ply].quietScores;
+
+    for (int i = 0; i < count; ++i) {
+        Move move = quiets[i];
+        int score = quietScore(board, move, ply);
+        int j = i;
+        for (; j > 0 && scores[j - 1] < score; --j) {
+            scores[j] = scores[j - 1];
+            quiets[j] = quiets[j - 1];
+        }
+        scores[j] = score;
+        quiets[j] = move;
+    }
+}
+
+/**
+ * updateQuietHeuristics - Learns from a quiet move that caused a beta cutoff.
+ * @board: Position of the node.
+ * @best: The quiet move that failed high.
+ * @tried: Quiet moves searched before it without a cutoff, they are punished.
+ * @triedCount: Number of moves in @tried.
+ * @depth: Remaining depth of the node, deeper cutoffs weigh more.
+ * @ply: Distance of the node from the root.
+ */
+static void updateQuietHeuristics(const BoardState& board, const Move& best, const Move* tried,
+                                  int triedCount, int depth, int ply) {
+    int bonus = std::min(HISTORY_BONUS_MAX, 32 * depth * depth);
+    int side = board.whiteToMove ? 0 : 1;
+
+    if (!sameMove(best, stack[ply].killers[0])) {
+        stack[ply].killers[1] = stack[ply].killers[0];
+        stack[ply].killers[0] = best;
+    }
+
+    const SearchFrame* prev1 = (ply >= 1 && stack[ply - 1].currentPiece >= 0) ? &stack[ply - 1] : nullptr;
+    const SearchFrame* prev2 = (ply >= 2 && stack[ply - 2].currentPiece >= 0) ? &stack[ply - 2] : nullptr;
+    if (prev1)
+        counterMoves[prev1->currentPiece][prev1->currentMove.to] = best;
+
+    auto update = [&](const Move& move, int amount) {
+        int piece = pieceOn(board, move.from);
+        updateHistory(quietHistory[side][move.from][move.to], amount);
+        if (prev1) updateHistory(continuationHistory[prev1->currentPiece][prev1->currentMove.to][piece][move.to], amount);
+        if (prev2) updateHistory(continuationHistory[prev2->currentPiece][prev2->currentMove.to][piece][move.to], amount);
+    };
+
+    update(best, bonus);
+    for (int i = 0; i < triedCount; ++i)
+        update(tried[i], -bonus);
+}
+
+/**
+ * negamax - Fail-soft negamax with principal variation search and transposition tables.
  * @board: Current state of the chess board.
- * @depth: Depth of the search tree.
+ * @depth: Remaining depth of the search tree.
  * @alpha: Alpha value for alpha-beta pruning.
  * @beta: Beta value for alpha-beta pruning.
- * @isMaximizingPlayer: True for the AI player, false for the opponent.
- * The function is an implementation of the Min-Max algorithm with Alpha-Beta pruning and transposition tables.
+ * @ply: Distance from the root.
+ * @allowNull: False directly after a null move (no two null moves in a row).
+ * Scores are always from the side to move's perspective. The first move is searched with
+ * the full window, the rest with a null window around alpha and re-searched with the
+ * full window only if they land inside it. Outside PV nodes and check, the selective
+ * search (see SearchOptions) prunes and reduces before and during the move loop.
  */
-int minimax(BoardState& board, int depth, int alpha, int beta, bool isMaximizingPlayer) {
-    // Compute Zobrist key for this node
-    uint64_t key = computeZobristKey(board);
+int negamax(BoardState& board, int depth, int alpha, int beta, int ply, bool allowNull) {
+    countNode();
+    const SearchOptions& searchOptions = boundContext->options;
+    SearchFrame& frame = stack[ply];
+    frame.pvLength = 0;
+
+    // Aborted search: the score is discarded by the caller
+    if (searchAborted())
+        return 0;
 
-    // Probe transposition table
+    // Hard ply limit, deeper lines are only evaluated
+    if (ply >= MAX_PLY - 1)
+        return evaluateBoard(board);
+
+    // Zobrist key of this node, kept incrementally by updateGameState / applyMove
+    uint64_t key = board.zobristKey;
+    assert(key == computeZobristKey(board));
+    frame.key = key;
+
+    // Draw by repetition or the fifty-move rule, before the TT whose scores ignore the path
+    if (ply > 0 && (board.halfmoveClock >= 100 || isRepetition(key, ply, board.halfmoveClock)))
+        return DRAW_SCORE;
+
+    bool pvNode = (beta - alpha > 1);
+    bool inCheck = isInCheck(board);
+    frame.inCheck = inCheck;
+    frame.staticEval = NO_EVAL;
+
+    // Mate distance pruning: no line from here beats a mate found closer to the root
+    alpha = std::max(alpha, -MATE_SCORE + ply);
+    beta = std::min(beta, MATE_SCORE - ply - 1);
+    if (alpha >= beta)
+        return alpha;
+
+    // Check extension, also keeps positions in check out of quiescence
+    if (inCheck && searchOptions.checkExtensions)
+        depth++;
+
+    // Leaf: resolve captures with quiescence, which probes the TT itself
+    if (depth <= 0)
+        return quiescence(board, alpha, beta, ply, QS_DEPTH_CHECKS);
+
+    // Probe transposition table, only cutoffs are taken so the window stays as given
     TTEntry ttEntry;
-    if (TT.probe(key, ttEntry)) {
-        if (ttEntry.depth >= depth) {
-            // Use stored info according to flag
-            if (ttEntry.flag == EXACT) {
-                return ttEntry.score;
-            } else if (ttEntry.flag == LOWERBOUND) {
-                if (ttEntry.score > alpha) alpha = ttEntry.score;
-            } else if (ttEntry.flag == UPPERBOUND) {
-                if (ttEntry.score < beta) beta = ttEntry.score;
-            }
-            if (alpha >= beta) {
-                return ttEntry.score;
+    bool ttHit = boundContext->tt->probe(key, ttEntry);
+    if (ttHit && ttEntry.depth >= depth) {
+        int ttScore = scoreFromTT(ttEntry.score, ply);
+        if (ttEntry.flag == EXACT)
+            return ttScore;
+        if (ttEntry.flag == LOWERBOUND && ttScore >= beta)
+            return ttScore;
+        if (ttEntry.flag == UPPERBOUND && ttScore <= alpha)
+            return ttScore;
+    }
+
+    // Node pruning, only where a wrong guess cannot change the principal variation
+    bool canPrune = !pvNode && !inCheck;
+    bool futilityPrune = false;
+    if (canPrune) {
+        int staticEval = staticEvalOf(board, ttHit, ttEntry);
+        frame.staticEval = staticEval;
+
+        // Reverse futility: far above beta, a quiet move will not lose it all
+        if (searchOptions.reverseFutility && depth <= RFP_MAX_DEPTH &&
+            staticEval - RFP_MARGIN * depth >= beta)
+            return staticEval;
+
+        // Razoring: far below alpha, only tactics can help, so ask quiescence
+        if (searchOptions.razoring && depth <= RAZOR_MAX_DEPTH &&
+            staticEval + RAZOR_MARGIN * depth <= alpha) {
+            int score = quiescence(board, alpha, alpha + 1, ply, QS_DEPTH_CHECKS);
+            if (score <= alpha)
+                return score;
+        }
+
+        // Null move: if passing still fails high, a real move will too
+        if (searchOptions.nullMove && allowNull && depth >= NULL_MIN_DEPTH &&
+            staticEval >= beta && hasNonPawnMaterial(board)) {
+            int R = NULL_REDUCTION + depth / 6;
+
+            BoardState& nullBoard = stack[ply + 1].board;
+            nullBoard = board;
+            nullBoard.whiteToMove = !board.whiteToMove;
+            nullBoard.zobristKey ^= zobristWhiteToMove;
+            if (nullBoard.enPassantSquare != -1)
+                nullBoard.zobristKey ^= zobristEnPassant[nullBoard.enPassantSquare % 8];
+            nullBoard.enPassantSquare = -1;
+            nullBoard.halfmoveClock = 0; // no repetition reaches across a null move
+            frame.currentPiece = -1; // no move context for the reply
+
+            int score = -negamax(nullBoard, depth - 1 - R, -beta, -beta + 1, ply + 1, false);
+            if (searchAborted())
+                return 0;
+
+            if (score >= beta) {
+                // Deep cutoffs are verified without null moves against zugzwang
+                if (depth < NULL_VERIFY_DEPTH)
+                    return beta;
+                if (negamax(board, depth - 1 - R, beta - 1, beta, ply, false) >= beta)
+                    return beta;
             }
         }
-    }
 
-    // Terminal or quiescence
-    if (depth == 0) {
-        int q = quiescence(board, alpha, beta);
-       // int q = quiescence(board, alpha, beta, isMaximizingPlayer);
-        // Store Q result into TT as exact at depth 0
-        TTEntry storeEntry;
-        storeEntry.key = key;
-        storeEntry.depth = 0;
-        storeEntry.score = q;
-        storeEntry.flag = EXACT;
-        // bestMove left untouched for quiescence
-        TT.store(storeEntry);
-        return q;
+        // Futility: quiet moves cannot lift this node above alpha
+        futilityPrune = searchOptions.futility && depth <= FUTILITY_MAX_DEPTH &&
+                        staticEval + FUTILITY_MARGIN * depth <= alpha;
     }
 
-    MoveList moves = generateLegalMoves(board);
+    MoveList& moves = frame.moves;
+    generateLegalMoves(board, moves);
 
-    // If no legal moves (checkmate or stalemate), evaluate board directly
+    // No legal moves: checkmated, the nearer the root the worse, or stalemate
     if (moves.moves.empty()) {
-        int ev = evaluateBoard(board);
-        // store terminal evaluation
+        int terminal = inCheck ? -MATE_SCORE + ply : DRAW_SCORE;
         TTEntry storeEntry;
         storeEntry.key = key;
         storeEntry.depth = depth;
-        storeEntry.score = ev;
+        storeEntry.score = scoreToTT(terminal, ply);
         storeEntry.flag = EXACT;
-        TT.store(storeEntry);
-        return ev;
+        boundContext->tt->store(storeEntry);
+        return terminal;
+    }
+
+    // Captures stay in MVV-LVA order, quiets are sorted by the cutoff heuristics
+    orderQuietMoves(board, moves.moves, ply);
+
+    // Search the transposition table move first (best move of a previous iteration)
+    if (ttHit && ttEntry.bestMove.from != ttEntry.bestMove.to) {
+        for (size_t i = 1; i < moves.moves.size(); ++i) {
+            if (sameMove(moves.moves[i], ttEntry.bestMove)) {
+                std::rotate(moves.moves.begin(), moves.moves.begin() + i, moves.moves.begin() + i + 1);
+                break;
+            }
+        }
     }
 
+    // Still on the previous iteration's principal variation: its move goes first
+    if (followPv) {
+        followPv = false;
+        if (ply < static_cast<int>(previousPv.size())) {
+            for (size_t i = 0; i < moves.moves.size(); ++i) {
+                if (sameMove(moves.moves[i], previousPv[ply])) {
+                    std::rotate(moves.moves.begin(), moves.moves.begin() + i, moves.moves.begin() + i + 1);
+                    followPv = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    int side = board.whiteToMove ? 0 : 1;
     int originalAlpha = alpha;
     Move bestMoveLocal{};
-    int bestScore;
+    int bestScore = -INF_SCORE;
+    int movesSearched = 0;
+    Move* quietsTried = frame.quietsTried;
+    int& quietsTriedCount = frame.quietsTriedCount;
+    quietsTriedCount = 0;
 
-    if (isMaximizingPlayer) {
-        bestScore = std::numeric_limits<int>::min();
-        for (const auto& move : moves.moves) {
-            BoardState newBoard = board;
+    for (size_t i = 0; i < moves.moves.size(); ++i) {
+        const Move& move = moves.moves[i];
 
-            updateGameState(newBoard, move);
-            applyMove(newBoard, move);
+        // Young brothers wait: once the eldest child is searched, idle threads may help
+        if (movesSearched > 0 && ybwcCanSplit(depth)) {
+            ybwcSplit(board, moves.moves, i, depth, ply, alpha, beta, bestScore, bestMoveLocal);
+            break;
+        }
 
-            if (!isLegalMoveState(newBoard)) {
-                continue; // skip illegal resulting states
-            }
+        BoardState& newBoard = stack[ply + 1].board;
+        newBoard = board;
 
-            int score = minimax(newBoard, depth - 1, alpha, beta, false);
+        updateGameState(newBoard, move);
+        applyMove(newBoard, move);
+        boundContext->tt->prefetch(newBoard.zobristKey);
 
-            if (score > bestScore) {
-                bestScore = score;
-                bestMoveLocal = move;
-            }
-            alpha = std::max(alpha, score);
-            if (alpha >= beta) {
-                break; // beta cutoff
-            }
+        if (!isLegalMoveState(newBoard)) {
+            continue; // skip illegal resulting states
         }
-    } else {
-        bestScore = std::numeric_limits<int>::max();
-        for (const auto& move : moves.moves) {
-            BoardState newBoard = board;
 
-            updateGameState(newBoard, move);
-            applyMove(newBoard, move);
+        bool quiet = isQuiet(move);
+        bool givesCheck = isInCheck(newBoard);
 
-            if (!isLegalMoveState(newBoard)) {
+        // Prune late quiet moves, never the first one so bestScore stays a real score
+        if (canPrune && movesSearched > 0 && quiet && !givesCheck) {
+            if (futilityPrune)
                 continue;
-            }
+            if (searchOptions.lateMovePruning && depth <= LMP_MAX_DEPTH &&
+                movesSearched >= LMP_BASE + 2 * depth * depth)
+                continue;
+        }
 
-            int score = minimax(newBoard, depth - 1, alpha, beta, true);
+        recordPlyMove(ply, board, move);
 
-            if (score < bestScore) {
-                bestScore = score;
-                bestMoveLocal = move;
+        int score;
+        if (movesSearched == 0) {
+            score = -negamax(newBoard, depth - 1, -beta, -alpha, ply + 1, true);
+        } else {
+            // Late move reductions, less for quiets with a good history
+            int reduction = 0;
+            if (searchOptions.lateMoveReductions && depth >= LMR_MIN_DEPTH &&
+                movesSearched >= LMR_MIN_MOVES && quiet && !inCheck && !givesCheck) {
+                reduction = lmrReduction(depth, movesSearched);
+                reduction -= quietHistory[side][move.from][move.to] / LMR_HISTORY_DIVISOR;
+                if (pvNode)
+                    reduction--;
+                reduction = std::max(0, std::min(reduction, depth - 2));
             }
-            beta = std::min(beta, score);
+
+            // Null window: only prove the move is not better than alpha
+            score = -negamax(newBoard, depth - 1 - reduction, -alpha - 1, -alpha, ply + 1, true);
+            if (reduction > 0 && score > alpha)
+                score = -negamax(newBoard, depth - 1, -alpha - 1, -alpha, ply + 1, true);
+            if (score > alpha && score < beta)
+                score = -negamax(newBoard, depth - 1, -beta, -alpha, ply + 1, true); // re-search
+        }
+        movesSearched++;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMoveLocal = move;
+            updatePv(ply, move);
+            if (score > alpha)
+                alpha = score;
             if (alpha >= beta) {
-                break; // alpha cutoff
+                if (quiet)
+                    updateQuietHeuristics(board, move, quietsTried, quietsTriedCount, depth, ply);
+                break; // beta cutoff
             }
         }
+        if (quiet && quietsTriedCount < 64)
+            quietsTried[quietsTriedCount++] = move;
     }
 
-    // Determine bound type to store
+    // Do not store results of an aborted search
+    if (searchAborted())
+        return 0;
+
+    // Determine bound type to store, relative to the window this node was called with
     BoundType flag = EXACT;
     if (bestScore <= originalAlpha) {
         flag = UPPERBOUND;
@@ -213,10 +911,11 @@ int minimax(BoardState& board, int depth, int alpha, int beta, bool isMaximizing
     TTEntry storeEntry;
     storeEntry.key = key;
     storeEntry.depth = depth;
-    storeEntry.score = bestScore;
+    storeEntry.score = scoreToTT(bestScore, ply);
     storeEntry.flag = flag;
     storeEntry.bestMove = bestMoveLocal;
-    TT.store(storeEntry);
+    storeEntry.eval = frame.staticEval == NO_EVAL ? TT_EVAL_NONE : frame.staticEval;
+    boundContext->tt->store(storeEntry);
 
     return bestScore;
 }
@@ -274,4 +973,437 @@ int minimax(BoardState& board, int depth, int alpha, int beta, bool isMaximizing
 //         }
 //         return minEval;
 //     }
-// }
\ No newline at end of file
+// }
+
+
+// ============================================================================
+//  SECTION 2: ITERATIVE DEEPENING
+// ============================================================================
+
+/**
+ * aspirationSearch - Runs one iteration inside an aspiration window, widening it until the score fits.
+ * @depth: Depth of the iteration.
+ * @prevScore: Score of the previous iteration, the centre of the window.
+ * @rootSearch: Callable (alpha, beta) -> best score that searches the root once.
+ * Below ASPIRATION_MIN_DEPTH the full window is used straight away.
+ */
+template <typename RootSearch>
+static int aspirationSearch(int depth, int prevScore, RootSearch rootSearch) {
+    int delta = ASPIRATION_WINDOW;
+    int alpha = -INF_SCORE;
+    int beta = INF_SCORE;
+    if (depth >= ASPIRATION_MIN_DEPTH) {
+        alpha = std::max(-INF_SCORE, prevScore - delta);
+        beta = std::min(INF_SCORE, prevScore + delta);
+    }
+
+    while (true) {
+        int bestScore = rootSearch(alpha, beta);
+        if (searchStopped())
+            return bestScore;
+
+        if (bestScore <= alpha && alpha > -INF_SCORE) {
+            alpha = std::max(-INF_SCORE, alpha - delta); // fail low
+        } else if (bestScore >= beta && beta < INF_SCORE) {
+            beta = std::min(INF_SCORE, beta + delta);    // fail high
+        } else {
+            return bestScore;
+        }
+        delta *= 2;
+    }
+}
+
+/**
+ * searchRoot - Searches every root move to the given depth, one thread pool task per move.
+ * @board: Root position.
+ * @rootMoves: Legal root moves, most promising first.
+ * @depth: Depth of the iteration, the root move itself counts as one ply.
+ * @alpha: Lower bound of the aspiration window.
+ * @beta: Upper bound of the aspiration window.
+ * @pool: Thread pool the root moves are distributed on.
+ * Returns the score of each root move, in the same order as @rootMoves.
+ */
+static std::vector<int> searchRoot(const BoardState& position, const std::vector<Move>& rootMoves,
+                                   int depth, int alpha, int beta, const std::vector<Move>& previousPv,
+                                   std::vector<PvLine>& lines, ThreadPool& pool) {
+    BoardState board = keyedRoot(position);
+    std::vector<std::future<int>> futures;
+    lines.assign(rootMoves.size(), PvLine{});
+
+    for (size_t i = 0; i < rootMoves.size(); ++i) {
+        const Move m = rootMoves[i];
+        PvLine* line = &lines[i];
+        futures.push_back(pool.enqueue([board, m, depth, alpha, beta, &previousPv, line]() -> int {
+            BoardState newBoard = board;
+
+            updateGameState(newBoard, m);
+            applyMove(newBoard, m);
+
+            if (!isLegalMoveState(newBoard)) {
+                return -INF_SCORE;
+            }
+
+            // Only the task of the previous best move continues along the previous PV
+            bool onPv = !previousPv.empty() && sameMove(m, previousPv.front());
+            followPreviousPv(onPv ? previousPv : std::vector<Move>{});
+
+            stack[0].key = board.zobristKey;
+            recordPlyMove(0, board, m);
+            int score = -negamax(newBoard, depth - 1, -beta, -alpha, 1, true);
+            updatePv(0, m);
+            getPv(0, *line);
+            flushNodes();
+            return score;
+        }));
+    }
+
+    std::vector<int> scores;
+    for (auto& fut : futures)
+        scores.push_back(fut.get());
+    return scores;
+}
+
+/**
+ * iterativeDeepening - Searches the root position at depth 1, 2, 3... up to maxDepth.
+ * @board: Root position.
+ * @maxDepth: Deepest iteration to run.
+ * @timeLimitMs: Soft time budget, scaled by the TimeManager between iterations (0 = no limit).
+ * @pool: Thread pool used for the root split.
+ * Every iteration re-orders the root moves by the previous scores, so the previous best
+ * move is searched first and the transposition table supplies the move ordering below it.
+ * From ASPIRATION_MIN_DEPTH on, the search starts with a narrow window around the previous
+ * score and widens it on fail-low / fail-high.
+ */
+SearchResult iterativeDeepening(const BoardState& board, int maxDepth, int timeLimitMs, ThreadPool& pool) {
+    SearchResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    MoveList legal = generateLegalMoves(board);
+    if (legal.moves.empty())
+        return result;
+
+    std::vector<Move> rootMoves = legal.moves;
+    result.pv = followExpectedLine(rootMoves);
+
+    // Always have a move ready, even if no iteration completes
+    result.bestMove = rootMoves.front();
+    result.found = true;
+
+    TimeManager timeManager(timeLimitMs, rootMoves.size());
+
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        std::vector<int> scores;
+        std::vector<PvLine> lines;
+        int bestScore = aspirationSearch(depth, result.score, [&](int alpha, int beta) {
+            scores = searchRoot(board, rootMoves, depth, alpha, beta, result.pv, lines, pool);
+            return *std::max_element(scores.begin(), scores.end());
+        });
+
+        if (searchStopped())
+            break; // the interrupted iteration is incomplete, keep the previous one
+
+        // Re-order root moves by score so the best move leads the next iteration
+        std::vector<size_t> order(rootMoves.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t a, size_t b) { return scores[a] > scores[b]; });
+        std::vector<Move> sorted;
+        for (size_t i : order) sorted.push_back(rootMoves[i]);
+        rootMoves = sorted;
+
+        const PvLine& best = lines[order.front()];
+        result.bestMove = rootMoves.front();
+        result.score = bestScore;
+        result.depth = depth;
+        result.pv.assign(best.moves, best.moves + best.length);
+        extendPvFromTT(board, result.pv);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        *boundContext->info << "info depth " << depth << " score " << scoreToString(bestScore)
+                            << " nodes " << boundContext->nodes.load()
+                            << " time " << elapsed << " pv " << pvToString(result.pv) << "\n";
+
+        if (timeManager.iterationDone(result.bestMove, bestScore, elapsed) && !deferStopToPonderhit())
+            break;
+    }
+
+    return result;
+}
+
+
+// ============================================================================
+//  SECTION 3: LAZY SMP
+// ============================================================================
+
+/**
+ * searchRootSerial - Principal variation search over the root moves on the calling thread.
+ * @board: Root position.
+ * @rootMoves: Legal root moves, the best one is moved to the front.
+ * @depth: Depth of the iteration, the root move itself counts as one ply.
+ * @alpha: Lower bound of the aspiration window.
+ * @beta: Upper bound of the aspiration window.
+ * Returns the best score (fail-soft).
+ */
+static int searchRootSerial(const BoardState& position, std::vector<Move>& rootMoves,
+                            int depth, int alpha, int beta) {
+    BoardState board = keyedRoot(position);
+    int bestScore = -INF_SCORE;
+    size_t bestIndex = 0;
+    stack[0].key = board.zobristKey;
+    stack[0].pvLength = 0;
+
+    for (size_t i = 0; i < rootMoves.size(); ++i) {
+        // Young brothers wait: split the remaining root moves once the first one is known
+        if (i > 0 && ybwcCanSplit(depth)) {
+            Move bestMove = rootMoves[bestIndex];
+            ybwcSplit(board, rootMoves, i, depth, 0, alpha, beta, bestScore, bestMove);
+            for (size_t j = 0; j < rootMoves.size(); ++j)
+                if (sameMove(rootMoves[j], bestMove))
+                    bestIndex = j;
+            break;
+        }
+
+        BoardState newBoard = board;
+
+        updateGameState(newBoard, rootMoves[i]);
+        applyMove(newBoard, rootMoves[i]);
+        recordPlyMove(0, board, rootMoves[i]);
+
+        int score;
+        if (i == 0) {
+            score = -negamax(newBoard, depth - 1, -beta, -alpha, 1, true);
+        } else {
+            score = -negamax(newBoard, depth - 1, -alpha - 1, -alpha, 1, true);
+            if (score > alpha && score < beta)
+                score = -negamax(newBoard, depth - 1, -beta, -alpha, 1, true);
+        }
+
+        if (searchStopped())
+            break;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestIndex = i;
+            updatePv(0, rootMoves[i]);
+            if (score > alpha)
+                alpha = score;
+            if (alpha >= beta)
+                break;
+        }
+    }
+
+    std::rotate(rootMoves.begin(), rootMoves.begin() + bestIndex, rootMoves.begin() + bestIndex + 1);
+    return bestScore;
+}
+
+/**
+ * iterativeDeepeningWorker - Single-threaded iterative deepening, one per Lazy SMP thread.
+ * @board: Root position.
+ * @rootMoves: Legal root moves.
+ * @maxDepth: Deepest iteration to run.
+ * @timeLimitMs: Soft time budget of the main thread (0 = no limit).
+ * @threadId: 0 for the main thread, 1..N-1 for helpers.
+ * Helpers perturb the search so the threads fill the TT with different subtrees: odd helpers
+ * start one ply deeper, and every helper rotates the root moves behind the best one by its id.
+ * Only the main thread reports iterations and applies the time limit; helpers run until
+ * their context is stopped.
+ */
+static SearchResult iterativeDeepeningWorker(const BoardState& board, std::vector<Move> rootMoves,
+                                  int maxDepth, int timeLimitMs, int threadId) {
+    SearchResult result;
+    result.pv = followExpectedLine(rootMoves);
+    result.bestMove = rootMoves.front();
+    result.found = true;
+
+    auto start = std::chrono::steady_clock::now();
+    bool mainThread = (threadId == 0);
+    TimeManager timeManager(timeLimitMs, rootMoves.size());
+
+    for (int depth = 1 + (threadId % 2); depth <= maxDepth; ++depth) {
+        if (!mainThread && rootMoves.size() > 2)
+            std::rotate(rootMoves.begin() + 1,
+                        rootMoves.begin() + 1 + (threadId % (rootMoves.size() - 1)),
+                        rootMoves.end());
+
+        int bestScore = aspirationSearch(depth, result.score, [&](int alpha, int beta) {
+            followPreviousPv(result.pv);
+            return searchRootSerial(board, rootMoves, depth, alpha, beta);
+        });
+
+        if (searchStopped())
+            break; // keep the last completed iteration
+
+        result.bestMove = rootMoves.front();
+        result.score = bestScore;
+        result.depth = depth;
+        result.pv = rootPv();
+        extendPvFromTT(board, result.pv);
+
+        if (mainThread) {
+            flushNodes();
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+            *boundContext->info << "info depth " << depth << " score " << scoreToString(bestScore)
+                                << " nodes " << boundContext->nodes.load()
+                                << " time " << elapsed << " pv " << pvToString(result.pv) << "\n";
+
+            if (timeManager.iterationDone(result.bestMove, bestScore, elapsed) && !deferStopToPonderhit())
+                break;
+        }
+    }
+
+    flushNodes();
+    return result;
+}
+
+/**
+ * lazySmpSearch - Lazy SMP: every thread runs its own iterative deepening on the shared TT.
+ * @board: Root position.
+ * @maxDepth: Deepest iteration of the main thread.
+ * @timeLimitMs: Soft time budget in milliseconds (0 = no limit).
+ * @numThreads: Total number of search threads, the calling thread is the main thread.
+ * @pool: Thread pool with at least numThreads - 1 workers, runs the helpers.
+ * The threads only cooperate through the transposition table; the result of the main
+ * thread is returned and the helpers are stopped as soon as it finishes.
+ */
+SearchResult lazySmpSearch(const BoardState& board, int maxDepth, int timeLimitMs,
+                           int numThreads, ThreadPool& pool) {
+    SearchResult result;
+
+    MoveList legal = generateLegalMoves(board);
+    if (legal.moves.empty())
+        return result;
+
+    std::vector<std::future<SearchResult>> helpers;
+    for (int id = 1; id < numThreads; ++id) {
+        helpers.push_back(pool.enqueue([&board, &legal, maxDepth, id]() {
+            return iterativeDeepeningWorker(board, legal.moves, maxDepth, 0, id);
+        }));
+    }
+
+    result = iterativeDeepeningWorker(board, legal.moves, maxDepth, timeLimitMs, 0);
+
+    boundContext->stopped = true;
+    for (auto& fut : helpers)
+        fut.get();
+
+    return result;
+}
+
+
+// ============================================================================
+//  SECTION 4: YOUNG BROTHERS WAIT CONCEPT
+// ============================================================================
+
+/**
+ * ybwcSearch - Iterative deepening where nodes split their younger brothers among idle threads.
+ * @board: Root position.
+ * @maxDepth: Deepest iteration.
+ * @timeLimitMs: Soft time budget in milliseconds (0 = no limit).
+ * @numThreads: Total number of search threads, the calling thread drives the search.
+ * @pool: Thread pool with at least numThreads - 1 workers, runs the helpers.
+ * The tree is searched in the same order as the serial search; helpers only steal moves
+ * from split points (see ybwc.cpp), so the result does not depend on a main/helper race.
+ */
+SearchResult ybwcSearch(const BoardState& board, int maxDepth, int timeLimitMs,
+                        int numThreads, ThreadPool& pool) {
+    SearchResult result;
+
+    MoveList legal = generateLegalMoves(board);
+    if (legal.moves.empty())
+        return result;
+
+    ybwcStartHelpers(numThreads - 1, pool);
+    result = iterativeDeepeningWorker(board, legal.moves, maxDepth, timeLimitMs, 0);
+    ybwcStopHelpers();
+
+    return result;
+}
+
+
+// ============================================================================
+//  SECTION 5: MULTIPV
+// ============================================================================
+
+/**
+ * multiPvSearch - Iterative deepening over several principal variations.
+ * Every iteration searches the root once per line: line k searches only the root moves that
+ * are not yet one of the k better lines of this iteration, so its best move is the k-th best
+ * move with an exact score. All lines run on the same thread, one after the other, and share
+ * the TT, history tables and killers, so the later lines mostly find their subtrees ordered
+ * already. Each line keeps its own aspiration window around its previous score.
+ */
+SearchResult multiPvSearch(const BoardState& board, int maxDepth, int timeLimitMs, int numLines,
+                           int numThreads, ThreadPool& pool) {
+    SearchResult result;
+
+    MoveList legal = generateLegalMoves(board);
+    if (legal.moves.empty())
+        return result;
+
+    std::vector<Move> rootMoves = legal.moves;
+    numLines = std::max(1, std::min(numLines, static_cast<int>(rootMoves.size())));
+
+    result.bestMove = rootMoves.front();
+    result.found = true;
+
+    auto start = std::chrono::steady_clock::now();
+    TimeManager timeManager(timeLimitMs, rootMoves.size());
+    ybwcStartHelpers(numThreads - 1, pool);
+
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        std::vector<RootLine> lines;
+
+        for (int k = 0; k < numLines; ++k) {
+            // The k better moves of this iteration stay at the front and are excluded
+            std::vector<Move> candidates(rootMoves.begin() + k, rootMoves.end());
+            const RootLine* previous = (k < static_cast<int>(result.lines.size())) ? &result.lines[k] : nullptr;
+
+            int score = aspirationSearch(depth, previous ? previous->score : 0, [&](int alpha, int beta) {
+                followPreviousPv(previous ? previous->pv : std::vector<Move>{});
+                return searchRootSerial(board, candidates, depth, alpha, beta);
+            });
+            if (searchStopped())
+                break;
+
+            std::copy(candidates.begin(), candidates.end(), rootMoves.begin() + k);
+            lines.push_back({rootMoves[k], score, rootPv()});
+            extendPvFromTT(board, lines.back().pv);
+        }
+
+        if (searchStopped())
+            break; // keep the lines of the last completed iteration
+
+        // Fail-soft scores of later lines can come out higher, rank them again
+        std::stable_sort(lines.begin(), lines.end(),
+                         [](const RootLine& a, const RootLine& b) { return a.score > b.score; });
+        for (int k = 0; k < numLines; ++k)
+            rootMoves[k] = lines[k].move;
+
+        result.lines = lines;
+        result.bestMove = lines.front().move;
+        result.score = lines.front().score;
+        result.pv = lines.front().pv;
+        result.depth = depth;
+
+        flushNodes();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        for (int k = 0; k < numLines; ++k)
+            *boundContext->info << "info depth " << depth << " multipv " << (k + 1)
+                                << " score " << scoreToString(lines[k].score)
+                                << " nodes " << boundContext->nodes.load() << " time " << elapsed
+                                << " pv " << pvToString(lines[k].pv) << "\n";
+
+        if (timeManager.iterationDone(result.bestMove, result.score, elapsed) && !deferStopToPonderhit())
+            break;
+    }
+
+    ybwcStopHelpers();
+    flushNodes();
+    return result;
+}
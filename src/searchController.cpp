@@ -0,0 +1,103 @@
+// searchController.cpp - Background search thread with stop, node limit and move time
+
+#include "searchController.h"
+#include "search.h"
+#include "mcts.h"
+#include "threadPool.h"
+
+#include <algorithm>
+
+
+/**
+ * runSearch - Runs the selected parallel search on the calling thread.
+ * MultiPV searches always use YBWC helpers, the lines are searched one after the other.
+ * MCTS is a different search altogether, not a parallel alpha-beta.
+ * @pool: Thread pool for the helper threads.
+ */
+static SearchResult runSearch(const BoardState& board, const SearchLimits& limits,
+                              SearchMode mode, int numThreads, ThreadPool& pool) {
+    if (limits.multiPv > 1)
+        return multiPvSearch(board, limits.maxDepth, limits.softTimeMs, limits.multiPv, numThreads, pool);
+    if (mode == LAZY_SMP)
+        return lazySmpSearch(board, limits.maxDepth, limits.softTimeMs, numThreads, pool);
+    if (mode == YBWC)
+        return ybwcSearch(board, limits.maxDepth, limits.softTimeMs, numThreads, pool);
+    if (mode == MCTS)
+        return mctsSearch(board, limits.maxDepth, limits.softTimeMs, numThreads, pool);
+    return iterativeDeepening(board, limits.maxDepth, limits.softTimeMs, pool);
+}
+
+SearchController::~SearchController() {
+    stop();
+    if (searchTask.valid())
+        searchTask.wait();
+}
+
+void SearchController::start(const BoardState& board, const SearchLimits& limits,
+                             SearchMode mode, int numThreads, DoneCallback onDone) {
+    stop();
+    if (searchTask.valid())
+        searchTask.wait();
+
+    // Threads are kept from search to search, only a new thread count replaces them.
+    // Each one searches for this controller's context for its whole life.
+    numThreads = std::max(1, numThreads);
+    SearchContext* searchContext = &context;
+    auto bindThread = [searchContext]() { bindSearchContext(searchContext); };
+    if (!driver)
+        driver = std::make_unique<ThreadPool>(1, bindThread);
+    if (!pool || poolThreads != numThreads) {
+        pool.reset();
+        pool = std::make_unique<ThreadPool>(numThreads, bindThread);
+        poolThreads = numThreads;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(resultMutex);
+        result = SearchResult{};
+        finished = false;
+    }
+
+    // Arm the limits before any search thread can poll them
+    context.tt->newSearch();
+    prepareSearch(context, limits);
+    running = true;
+
+    searchTask = driver->enqueue([this, board, limits, mode, numThreads, onDone]() {
+        SearchResult searchResult = runSearch(board, limits, mode, numThreads, *pool);
+        if (onDone)
+            onDone(searchResult);
+
+        {
+            std::lock_guard<std::mutex> guard(resultMutex);
+            result = searchResult;
+            finished = true;
+        }
+        running = false;
+        searchDone.notify_all();
+    });
+}
+
+void SearchController::stop() {
+    if (running.load())
+        context.stopped = true;
+}
+
+void SearchController::resetThreads() {
+    stop();
+    if (searchTask.valid())
+        searchTask.wait();
+    pool.reset();
+    driver.reset();
+    poolThreads = 0;
+}
+
+void SearchController::ponderHit() {
+    ::ponderHit(context);
+}
+
+SearchResult SearchController::wait() {
+    std::unique_lock<std::mutex> lk(resultMutex);
+    searchDone.wait(lk, [this]() { return finished; });
+    return result;
+}
@@ -0,0 +1,109 @@
+// see.cpp - Static exchange evaluation (swap list algorithm)
+
+#include "see.h"
+#include "movegen.h"
+
+#include <algorithm>
+
+
+// Value of the piece on sq (0 if empty)
+static int valueOn(const BoardState& board, int sq) {
+    uint64_t bit = 1ULL << sq;
+    if ((board.whitePawns   | board.blackPawns)   & bit) return SEE_PAWN;
+    if ((board.whiteKnights | board.blackKnights) & bit) return SEE_KNIGHT;
+    if ((board.whiteBishops | board.blackBishops) & bit) return SEE_BISHOP;
+    if ((board.whiteRooks   | board.blackRooks)   & bit) return SEE_ROOK;
+    if ((board.whiteQueens  | board.blackQueens)  & bit) return SEE_QUEEN;
+    if ((board.whiteKing    | board.blackKing)    & bit) return SEE_KING;
+    return 0;
+}
+
+static int promotionValue(char promotion) {
+    switch (promotion) {
+        case 'Q': case 'q': return SEE_QUEEN;
+        case 'R': case 'r': return SEE_ROOK;
+        case 'B': case 'b': return SEE_BISHOP;
+        case 'N': case 'n': return SEE_KNIGHT;
+        default: return 0;
+    }
+}
+
+int capturedValue(const BoardState& board, const Move& move) {
+    if (move.isEnPassant) return SEE_PAWN;
+    if (!move.isCapture) return 0;
+    return valueOn(board, move.to);
+}
+
+/**
+ * Finds the least valuable piece of one side among `attackers`.
+ * Returns its square bitboard (0 if none) and stores its value in `value`.
+ */
+static uint64_t leastValuableAttacker(const BoardState& board, uint64_t attackers, bool white, int& value) {
+    const uint64_t pieces[6] = {
+        white ? board.whitePawns   : board.blackPawns,
+        white ? board.whiteKnights : board.blackKnights,
+        white ? board.whiteBishops : board.blackBishops,
+        white ? board.whiteRooks   : board.blackRooks,
+        white ? board.whiteQueens  : board.blackQueens,
+        white ? board.whiteKing    : board.blackKing
+    };
+    const int values[6] = { SEE_PAWN, SEE_KNIGHT, SEE_BISHOP, SEE_ROOK, SEE_QUEEN, SEE_KING };
+
+    for (int p = 0; p < 6; ++p) {
+        uint64_t subset = attackers & pieces[p];
+        if (subset) {
+            value = values[p];
+            return subset & -subset; // lowest set bit
+        }
+    }
+    return 0;
+}
+
+int staticExchange(const BoardState& board, const Move& move) {
+    int gain[32];
+    int d = 0;
+
+    uint64_t occupied = board.whitePawns | board.whiteKnights | board.whiteBishops |
+                        board.whiteRooks | board.whiteQueens | board.whiteKing |
+                        board.blackPawns | board.blackKnights | board.blackBishops |
+                        board.blackRooks | board.blackQueens | board.blackKing;
+
+    uint64_t bishopsQueens = board.whiteBishops | board.blackBishops | board.whiteQueens | board.blackQueens;
+    uint64_t rooksQueens   = board.whiteRooks   | board.blackRooks   | board.whiteQueens | board.blackQueens;
+
+    // First capture: the target is gained, the moving piece now stands on it
+    gain[0] = capturedValue(board, move);
+    int attackerValue = valueOn(board, move.from);
+    if (move.promotion != '\0') {
+        gain[0] += promotionValue(move.promotion) - SEE_PAWN;
+        attackerValue = promotionValue(move.promotion);
+    }
+
+    uint64_t fromSet = 1ULL << move.from;
+    if (move.isEnPassant)
+        occupied ^= 1ULL << (board.whiteToMove ? move.to - 8 : move.to + 8);
+
+    uint64_t attackers = attackersTo(board, move.to, occupied);
+    bool white = board.whiteToMove;
+
+    do {
+        d++;
+        // Speculative: what the side to recapture wins if it takes the piece on the target
+        gain[d] = attackerValue - gain[d - 1];
+
+        // Remove the capturing piece and uncover x-ray attackers behind it
+        occupied ^= fromSet;
+        attackers |= (bishopAttacks(move.to, occupied) & bishopsQueens) |
+                     (rookAttacks(move.to, occupied) & rooksQueens);
+        attackers &= occupied;
+
+        white = !white;
+        fromSet = leastValuableAttacker(board, attackers, white, attackerValue);
+    } while (fromSet && d < 31);
+
+    // Negamax the swap list back to the first capture
+    while (--d)
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+
+    return gain[0];
+}
@@ -0,0 +1,65 @@
+// timeManager.cpp - Time allocation from the game clock and iteration-based soft limits
+
+#include "timeManager.h"
+
+#include <algorithm>
+
+
+// Assumed number of moves left in the game when the time control does not say
+static const int DEFAULT_MOVES_TO_GO = 30;
+static const int MAX_MOVES_TO_GO = 50;
+
+// The hard limit is at most this many soft limits, and never more than 80% of the clock
+static const int HARD_LIMIT_FACTOR = 5;
+
+// Soft limit scaling
+static const double UNSTABLE_FACTOR = 1.4;     // best move changed in the last iteration
+static const double STABLE_STEP = 0.1;         // shrink per iteration with the same best move
+static const double MIN_STABILITY_FACTOR = 0.5;
+static const int VOLATILITY_SCALE = 100;       // score drop (cp) that doubles the soft limit
+
+TimeBudget allocateTime(const TimeControl& tc, bool whiteToMove) {
+    TimeBudget budget;
+    int time = whiteToMove ? tc.wtime : tc.btime;
+    int inc = whiteToMove ? tc.winc : tc.binc;
+    if (time <= 0)
+        return budget;
+
+    int movesToGo = (tc.movestogo > 0) ? std::min(tc.movestogo, MAX_MOVES_TO_GO) : DEFAULT_MOVES_TO_GO;
+    int available = std::max(1, time - tc.moveOverhead);
+
+    budget.hardMs = std::max(1, std::min(available * 8 / 10, (available / movesToGo + inc) * HARD_LIMIT_FACTOR));
+    budget.softMs = std::max(1, std::min(budget.hardMs, available / movesToGo + inc * 3 / 4));
+    return budget;
+}
+
+TimeManager::TimeManager(int softMs, size_t numRootMoves)
+    : softMs(softMs), singleMove(numRootMoves == 1) {}
+
+bool TimeManager::iterationDone(const Move& bestMove, int score, int64_t elapsedMs) {
+    bool sameBest = iterations > 0 && bestMove.from == previousBest.from &&
+                    bestMove.to == previousBest.to && bestMove.promotion == previousBest.promotion;
+    stableIterations = sameBest ? stableIterations + 1 : 0;
+
+    // A falling score means trouble the search has only just seen, give it more time
+    double volatility = 1.0;
+    if (iterations > 0 && score < previousScore)
+        volatility += std::min(1.0, static_cast<double>(previousScore - score) / VOLATILITY_SCALE);
+
+    // A fresh best move needs confirmation; one that keeps winning is an easy move
+    double stability = (iterations > 0 && !sameBest)
+                           ? UNSTABLE_FACTOR
+                           : std::max(MIN_STABILITY_FACTOR, 1.0 - STABLE_STEP * stableIterations);
+
+    iterations++;
+    previousBest = bestMove;
+    previousScore = score;
+
+    if (softMs <= 0)
+        return false;
+    if (singleMove)
+        return true; // nothing to choose from
+
+    // The next iteration takes about as long as all previous ones together
+    return elapsedMs * 2 > static_cast<int64_t>(softMs * stability * volatility);
+}
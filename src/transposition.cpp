@@ -0,0 +1,102 @@
+// transposition.cpp - Memory of the transposition table: huge-page mappings, resizing and clearing
+
+#include "transposition.h"
+
+#include <sys/mman.h>
+
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+
+/**
+ * mapTable - Maps @bytes (a multiple of TT_HUGE_PAGE) of zeroed memory aligned to TT_HUGE_PAGE
+ * and asks for huge pages on it. Without huge pages the table still works on normal pages.
+ * @huge: Set to true if the system accepted the huge page request.
+ * Returns nullptr if the memory cannot be mapped.
+ */
+static TTCluster* mapTable(size_t bytes, bool& huge) {
+    // Map one huge page more than needed and cut the unaligned ends off
+    size_t length = bytes + TT_HUGE_PAGE;
+    void* mem = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+        return nullptr;
+
+    uintptr_t start = reinterpret_cast<uintptr_t>(mem);
+    uintptr_t aligned = (start + TT_HUGE_PAGE - 1) & ~uintptr_t(TT_HUGE_PAGE - 1);
+    if (aligned > start)
+        munmap(mem, aligned - start);
+    if (start + length > aligned + bytes)
+        munmap(reinterpret_cast<void*>(aligned + bytes), start + length - (aligned + bytes));
+
+    huge = false;
+#ifdef MADV_HUGEPAGE
+    huge = madvise(reinterpret_cast<void*>(aligned), bytes, MADV_HUGEPAGE) == 0;
+#endif
+    return reinterpret_cast<TTCluster*>(aligned);
+}
+
+// Bytes mapped for a table of mb megabytes
+static size_t tableBytes(size_t mb) {
+    size_t bytes = std::max<size_t>(mb, 1) * 1024 * 1024;
+    return (bytes + TT_HUGE_PAGE - 1) / TT_HUGE_PAGE * TT_HUGE_PAGE;
+}
+
+TranspositionTable::TranspositionTable(size_t mb) {
+    mappedBytes = tableBytes(mb);
+    table = mapTable(mappedBytes, huge);
+    if (!table)
+        throw std::bad_alloc();
+    clusterCount = mappedBytes / sizeof(TTCluster);
+    size = clusterCount * TT_CLUSTER_SIZE;
+}
+
+TranspositionTable::~TranspositionTable() {
+    munmap(table, mappedBytes);
+}
+
+bool TranspositionTable::resize(size_t mb, int numThreads) {
+    if (mb < 1 || mb > TT_MAX_MB)
+        return false;
+
+    // Map the new table first, a failure leaves the old one in place
+    bool newHuge = false;
+    size_t bytes = tableBytes(mb);
+    TTCluster* mem = mapTable(bytes, newHuge);
+    if (!mem)
+        return false;
+
+    munmap(table, mappedBytes);
+    table = mem;
+    mappedBytes = bytes;
+    huge = newHuge;
+    clusterCount = bytes / sizeof(TTCluster);
+    size = clusterCount * TT_CLUSTER_SIZE;
+
+    // Already zero, clearing places the pages (first touch) over the clearing threads
+    clear(numThreads);
+    return true;
+}
+
+void TranspositionTable::clear(int numThreads) {
+    size_t threads = numThreads > 0 ? size_t(numThreads)
+                                     : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max<size_t>(1, std::min(threads, mappedBytes / TT_CLEAR_CHUNK));
+
+    // All-zero slots are empty (see ttpack)
+    size_t perThread = (clusterCount + threads - 1) / threads;
+    auto clearPart = [this, perThread](size_t part) {
+        size_t first = part * perThread;
+        size_t last = std::min(clusterCount, first + perThread);
+        if (first < last)
+            std::memset(static_cast<void*>(table + first), 0, (last - first) * sizeof(TTCluster));
+    };
+
+    std::vector<std::thread> helpers;
+    for (size_t part = 1; part < threads; ++part)
+        helpers.emplace_back(clearPart, part);
+    clearPart(0);
+    for (auto& helper : helpers)
+        helper.join();
+}
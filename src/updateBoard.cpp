@@ -82,9 +82,18 @@ void updateCastlingRights(BoardState& board, const Move& move) {
 }
 
 // Function that updates the castling rights and en passant square after a move
+// Keeps their zobrist keys in board.zobristKey, applyMove does the pieces and the side to move
 void updateGameState(BoardState& board, const Move& move) {
+    board.zobristKey ^= zobristCastling[castlingMask(board.castlingRights)];
+    if (board.enPassantSquare != -1)
+        board.zobristKey ^= zobristEnPassant[board.enPassantSquare % 8];
+
     updateCastlingRights(board, move);
     updateEnPassantSquare(board, move);
+
+    board.zobristKey ^= zobristCastling[castlingMask(board.castlingRights)];
+    if (board.enPassantSquare != -1)
+        board.zobristKey ^= zobristEnPassant[board.enPassantSquare % 8];
 }
 
 // helper: map (color, piece type enum used earlier) -> zobrist index
@@ -98,10 +107,6 @@ static inline int pieceIndex(bool white, int pieceEnum) {
 void applyMove(BoardState& board, const Move& move) {
     bool white = board.whiteToMove;
     
-    // Save previous state for zobrist updates
-    int oldCastlingMask = castlingMask(board.castlingRights);
-    int oldEnPassant = board.enPassantSquare; // -1 if none
-
     // increment halfmove clock (bookkeeping)
     board.halfmoveClock++;
 
@@ -129,6 +134,10 @@ void applyMove(BoardState& board, const Move& move) {
     else if (GET_BIT(myQueens, move.from)) movedPiece = QUEEN;
     else movedPiece = KING; // must be king
 
+    // Pawn moves are irreversible, restart the fifty-move count
+    if (movedPiece == PAWN)
+        board.halfmoveClock = 0;
+
     // === Zobrist: XOR out moving piece from 'from' square ===
     board.zobristKey ^= zobristTable[pieceIndex(white, movedPiece)][move.from];
 
@@ -291,27 +300,7 @@ void applyMove(BoardState& board, const Move& move) {
         }
     }
 
-    // === Zobrist: XOR out old castling & old en-passant keys before updateGameState ===
-    board.zobristKey ^= zobristCastling[oldCastlingMask];
-    if (oldEnPassant != -1) {
-        int oldFile = oldEnPassant % 8;
-        assert(oldFile >= 0 && oldFile < 8);
-        board.zobristKey ^= zobristEnPassant[oldFile];
-    }
-
-    // === 7) Game-state bookkeeping (EP square, castling rights, clocks) ===
-    //updateGameState(board, move);
-
-    // === Zobrist: XOR in new castling & new en-passant keys after updateGameState ===
-    int newCastlingMask = castlingMask(board.castlingRights);
-    board.zobristKey ^= zobristCastling[newCastlingMask];
-
-    int newEnPassant = board.enPassantSquare;
-    if (newEnPassant != -1) {
-        int newFile = newEnPassant % 8;
-        assert(newFile >= 0 && newFile < 8);
-        board.zobristKey ^= zobristEnPassant[newFile];
-    }
+    // === 7) Castling & en-passant keys: updated by updateGameState, called before applyMove ===
 
     // === 8) Toggle side to move in zobrist and switch side ===
     board.zobristKey ^= zobristWhiteToMove;
@@ -0,0 +1,244 @@
+// ybwc.cpp - Young Brothers Wait Concept: a node searches its eldest child alone, then offers
+// the remaining children as a split point. Idle helper threads steal moves from open split
+// points, and a fail-high at a split point aborts every thread still working below it.
+
+#include "ybwc.h"
+#include "search.h"
+#include "updateBoard.h"
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+// ============================================================================
+//  SECTION 1: SPLIT POINTS
+// ============================================================================
+
+/**
+ * A node whose younger brothers are searched in parallel.
+ * The owner thread keeps it on its stack until every helper has left.
+ */
+struct SplitPoint {
+    const BoardState* board;
+    const std::vector<Move>* moves;
+    int depth;
+    int ply;
+    int beta;
+    const SearchStack* stack;          // owner's line up to the node, for repetition detection
+    SplitPoint* parent;                // split point the owner was working under
+
+    std::atomic<size_t> nextMove;      // next move to hand out
+    std::atomic<bool> cutoff{false};   // set on a fail-high, aborts all brothers
+    std::atomic<int> helpers{0};       // threads currently searching here besides the owner
+
+    std::mutex lock;                   // guards the fields below
+    int alpha;
+    int bestScore;
+    Move bestMove;
+    PvLine pv;                         // principal variation of bestMove, if a brother improved it
+};
+
+/**
+ * Split points and helpers of one search context, so engines in one process never share work.
+ */
+struct YbwcState {
+    std::vector<SplitPoint*> openSplits;  // split points with moves left to steal
+    std::mutex splitMutex;
+    std::condition_variable splitAvailable;
+
+    std::atomic<bool> helpersRunning{false};
+    std::atomic<int> idleHelpers{0};
+    std::vector<std::future<void>> helperTasks;
+};
+
+// Innermost split point the calling thread works under (nullptr outside YBWC)
+static thread_local SplitPoint* activeSplit = nullptr;
+
+bool ybwcAborted() {
+    for (SplitPoint* sp = activeSplit; sp != nullptr; sp = sp->parent)
+        if (sp->cutoff.load(std::memory_order_relaxed))
+            return true;
+    return false;
+}
+
+bool ybwcCanSplit(int depth) {
+    const YbwcState* state = searchContext().ybwc.get();
+    return depth >= YBWC_MIN_SPLIT_DEPTH && state &&
+           state->helpersRunning.load(std::memory_order_relaxed) &&
+           state->idleHelpers.load(std::memory_order_relaxed) > 0;
+}
+
+/**
+ * searchSplitMoves - Takes moves from the split point and searches them until none are left.
+ * Runs on the owner and on every helper; each move is searched with a null window around
+ * the shared alpha and re-searched with the full window if it lands inside it.
+ */
+static void searchSplitMoves(SplitPoint& sp) {
+    const std::vector<Move>& moves = *sp.moves;
+
+    while (!sp.cutoff.load(std::memory_order_relaxed)) {
+        size_t i = sp.nextMove.fetch_add(1);
+        if (i >= moves.size())
+            return;
+
+        int alpha;
+        {
+            std::lock_guard<std::mutex> guard(sp.lock);
+            alpha = sp.alpha;
+        }
+
+        BoardState newBoard = *sp.board;
+        updateGameState(newBoard, moves[i]);
+        applyMove(newBoard, moves[i]);
+        recordPlyMove(sp.ply, *sp.board, moves[i]);
+
+        int score = -negamax(newBoard, sp.depth - 1, -alpha - 1, -alpha, sp.ply + 1, true);
+        if (score > alpha && score < sp.beta)
+            score = -negamax(newBoard, sp.depth - 1, -sp.beta, -alpha, sp.ply + 1, true);
+
+        // Results of an aborted subtree are meaningless
+        if (ybwcAborted() || searchContext().stopped.load(std::memory_order_relaxed))
+            return;
+
+        std::lock_guard<std::mutex> guard(sp.lock);
+        if (score > sp.bestScore) {
+            sp.bestScore = score;
+            sp.bestMove = moves[i];
+            updatePv(sp.ply, moves[i]);
+            getPv(sp.ply, sp.pv);
+            if (score > sp.alpha)
+                sp.alpha = score;
+            if (sp.alpha >= sp.beta)
+                sp.cutoff = true; // notify the brothers
+        }
+    }
+}
+
+void ybwcSplit(const BoardState& board, const std::vector<Move>& moves, size_t first,
+               int depth, int ply, int& alpha, int beta, int& bestScore, Move& bestMove) {
+    YbwcState& state = *searchContext().ybwc;
+    SplitPoint sp;
+    sp.board = &board;
+    sp.moves = &moves;
+    sp.depth = depth;
+    sp.ply = ply;
+    sp.beta = beta;
+    sp.stack = searchStack();
+    sp.parent = activeSplit;
+    sp.nextMove = first;
+    sp.alpha = alpha;
+    sp.bestScore = bestScore;
+    sp.bestMove = bestMove;
+
+    {
+        std::lock_guard<std::mutex> guard(state.splitMutex);
+        state.openSplits.push_back(&sp);
+    }
+    state.splitAvailable.notify_all();
+
+    // The owner works on its own split point like any helper
+    activeSplit = &sp;
+    searchSplitMoves(sp);
+    activeSplit = sp.parent;
+
+    // Close the split point, then wait for the helpers still searching a brother
+    {
+        std::lock_guard<std::mutex> guard(state.splitMutex);
+        for (size_t i = 0; i < state.openSplits.size(); ++i) {
+            if (state.openSplits[i] == &sp) {
+                state.openSplits.erase(state.openSplits.begin() + i);
+                break;
+            }
+        }
+    }
+    while (sp.helpers.load() > 0)
+        std::this_thread::yield();
+
+    alpha = sp.alpha;
+    bestScore = sp.bestScore;
+    bestMove = sp.bestMove;
+    if (sp.pv.length > 0)
+        setPv(ply, sp.pv);
+}
+
+
+// ============================================================================
+//  SECTION 2: HELPER THREADS
+// ============================================================================
+
+// Picks the open split point closest to the root (largest remaining depth), nullptr if none.
+// Must be called with the state's splitMutex held.
+static SplitPoint* stealSplitPoint(YbwcState& state) {
+    SplitPoint* best = nullptr;
+    for (SplitPoint* sp : state.openSplits) {
+        if (sp->cutoff.load() || sp->nextMove.load() >= sp->moves->size())
+            continue;
+        if (!best || sp->depth > best->depth)
+            best = sp;
+    }
+    return best;
+}
+
+/**
+ * helperLoop - Waits for open split points and searches moves stolen from them.
+ */
+static void helperLoop(YbwcState& state) {
+    while (true) {
+        SplitPoint* sp = nullptr;
+        {
+            std::unique_lock<std::mutex> lk(state.splitMutex);
+            state.idleHelpers++;
+            state.splitAvailable.wait(lk, [&]() {
+                if (!state.helpersRunning.load()) return true;
+                sp = stealSplitPoint(state);
+                return sp != nullptr;
+            });
+            state.idleHelpers--;
+            if (!state.helpersRunning.load())
+                break;
+            sp->helpers++; // under the split mutex, so the owner cannot close it in between
+        }
+
+        // The helper did not play the moves above the split point, drop their ordering context
+        // but take over the owner's line, which stays unchanged while the split point is open
+        resetPlyMoves();
+        loadSearchPath(sp->stack, sp->ply + 1);
+
+        activeSplit = sp;
+        searchSplitMoves(*sp);
+        activeSplit = nullptr;
+
+        sp->helpers--;
+    }
+
+    flushNodes();
+}
+
+void ybwcStartHelpers(int numHelpers, ThreadPool& pool) {
+    SearchContext& context = searchContext();
+    if (!context.ybwc)
+        context.ybwc = std::make_shared<YbwcState>();
+
+    YbwcState& state = *context.ybwc;
+    state.helpersRunning = true;
+    for (int i = 0; i < numHelpers; ++i)
+        state.helperTasks.push_back(pool.enqueue([&state]() { helperLoop(state); }));
+}
+
+void ybwcStopHelpers() {
+    YbwcState& state = *searchContext().ybwc;
+    {
+        std::lock_guard<std::mutex> guard(state.splitMutex);
+        state.helpersRunning = false;
+    }
+    state.splitAvailable.notify_all();
+
+    for (auto& task : state.helperTasks)
+        task.get();
+    state.helperTasks.clear();
+}
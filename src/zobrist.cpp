@@ -9,29 +9,31 @@ uint64_t zobristCastling[16];   // 16 possible combinations of KQkq
 uint64_t zobristEnPassant[8];   // En passant files
 
 // Generate a random 64-bit number
-static uint64_t random64() {
-    static std::mt19937_64 rng(2025);  // fixed seed for determinism
-    static std::uniform_int_distribution<uint64_t> dist;
+static uint64_t random64(std::mt19937_64& rng) {
+    std::uniform_int_distribution<uint64_t> dist;
     return dist(rng);
 }
 
 // Initialize Zobrist hashing tables with random values
+// Reseeded on every call, so keys stay the same across calls and can be kept between searches
 void initZobrist() {
+    std::mt19937_64 rng(2025);  // fixed seed for determinism
+
     // Fill piece-square table
     for (int p = 0; p < 12; ++p)
         for (int sq = 0; sq < 64; ++sq)
-            zobristTable[p][sq] = random64();
+            zobristTable[p][sq] = random64(rng);
 
     // Side to move
-    zobristWhiteToMove = random64();
+    zobristWhiteToMove = random64(rng);
 
     // 16 combinations of KQkq castling rights
     for (int i = 0; i < 16; ++i)
-        zobristCastling[i] = random64();
+        zobristCastling[i] = random64(rng);
 
     // En passant for each file
     for (int i = 0; i < 8; ++i)
-        zobristEnPassant[i] = random64();
+        zobristEnPassant[i] = random64(rng);
 }
 
 // Helper: convert castling string (like "KQkq") into a 4-bit mask
@@ -0,0 +1,27 @@
+// engineApiTest.cpp - Checks of the embeddable Engine API, built by "make engine_test"
+
+#include "testing.h"
+#include "engineApi.h"
+#include "parsing.h"
+
+#include <string>
+
+// A FEN that cannot be parsed is rejected and the previous position stays
+static void testBadFenKeepsPosition() {
+    Engine engine(1);
+    const std::string fen = "4k3/8/8/8/8/8/8/4K2R w K - 0 1";
+    check(engine.setPosition(fen), "valid FEN is accepted");
+
+    check(!engine.setPosition("hello"), "malformed FEN is rejected");
+    check(parseFEN(fen).whiteRooks == engine.position().whiteRooks, "malformed FEN keeps the position");
+
+    check(!engine.setPosition("8/8/8/8/8/8/8/K6k w - -"), "truncated FEN is rejected");
+    check(parseFEN(fen).whiteRooks == engine.position().whiteRooks, "truncated FEN keeps the position");
+
+    check(!engine.setPosition(fen, {"e1e2", "e9e8"}), "invalid move is rejected");
+    check(parseFEN(fen).whiteKing == engine.position().whiteKing, "invalid move keeps the position");
+}
+
+void engineApiTests() {
+    testBadFenKeepsPosition();
+}
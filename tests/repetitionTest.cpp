@@ -0,0 +1,40 @@
+// repetitionTest.cpp - Draws by repetition: twofold inside the search tree, threefold with the game history
+
+#include "testing.h"
+#include "engineApi.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Black is a queen and two rooks up, white holds the draw with Qh5+ Kg8 Qe8+ Kh7
+static const std::string PERPETUAL = "4Q3/6pk/5p2/8/8/8/qrr5/7K w - - 10 60";
+static const std::vector<std::string> CYCLE = {"e8h5", "h7g8", "h5e8", "g8h7"};
+
+// Score of a search to @depth of PERPETUAL after @moves, for white (to move at the root)
+static int searchScore(const std::vector<std::string>& moves, int depth) {
+    Engine engine(1);
+    std::ostringstream quiet;
+    engine.setInfoStream(quiet);
+    check(engine.setPosition(PERPETUAL, moves), "repetition: position is accepted");
+
+    SearchLimits limits;
+    limits.maxDepth = depth;
+    engine.search(limits);
+    return engine.wait().score;
+}
+
+void repetitionTests() {
+    // Four plies deep the root comes back: a draw without any game history
+    check(searchScore({}, 6) == 0, "repetition: twofold in the tree is a draw");
+    check(searchScore({}, 1) < -500, "repetition: one ply cannot reach the draw");
+
+    // Qh5+ at ply 1 repeats a position the game has seen once: twofold only, not a draw yet
+    std::vector<std::string> once = CYCLE;
+    check(searchScore(once, 1) < -500, "repetition: a single earlier occurrence is not a draw");
+
+    // Seen twice in the game, the third occurrence is a draw
+    std::vector<std::string> twice = CYCLE;
+    twice.insert(twice.end(), CYCLE.begin(), CYCLE.end());
+    check(searchScore(twice, 1) == 0, "repetition: threefold with the game history is a draw");
+}
@@ -0,0 +1,33 @@
+// seeTest.cpp - Static exchange evaluation of known captures
+
+#include "testing.h"
+#include "parsing.h"
+#include "see.h"
+
+#include <string>
+
+// Exchange value of @move in @fen, checked against @expected
+static void checkExchange(const std::string& fen, const std::string& move, int expected, const std::string& what) {
+    BoardState board = parseFEN(fen);
+    Move m = findMove(board, move);
+    check(m.from != m.to, what + ": " + move + " is legal");
+    check(staticExchange(board, m) == expected, what);
+}
+
+void seeTests() {
+    checkExchange("4k3/8/8/3n4/4P3/8/8/4K3 w - - 0 1", "e4d5", SEE_KNIGHT,
+                  "SEE: pawn takes an undefended knight");
+    checkExchange("4k3/8/2p5/3p4/8/8/3R4/4K3 w - - 0 1", "d2d5", SEE_PAWN - SEE_ROOK,
+                  "SEE: rook takes a pawn defended by a pawn");
+    checkExchange("4k3/2n5/8/3p4/8/8/3R4/4K3 w - - 0 1", "d2d5", SEE_PAWN - SEE_ROOK,
+                  "SEE: rook takes a pawn defended by a knight");
+    checkExchange("4k3/2n5/8/3p4/8/8/3R4/3QK3 w - - 0 1", "d2d5", SEE_PAWN - SEE_ROOK + SEE_KNIGHT,
+                  "SEE: the queen behind the rook recaptures (x-ray)");
+    checkExchange("4k3/8/2p5/3q4/4P3/8/8/4K3 w - - 0 1", "e4d5", SEE_QUEEN - SEE_PAWN,
+                  "SEE: pawn takes a queen defended by a pawn");
+    checkExchange("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", "e5d6", SEE_PAWN,
+                  "SEE: en passant wins a pawn");
+
+    BoardState board = parseFEN("4k3/8/8/8/8/8/4P3/4K3 w - - 0 1");
+    check(capturedValue(board, findMove(board, "e2e4")) == 0, "SEE: a quiet move captures nothing");
+}
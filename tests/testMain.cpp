@@ -0,0 +1,40 @@
+// testMain.cpp - Runs every check group of the engine_test target
+
+#include "testing.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <iostream>
+
+static int failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << "\n";
+        ++failures;
+    }
+}
+
+Move findMove(const BoardState& board, const std::string& text) {
+    MoveList legal = generateLegalMoves(board);
+    auto it = std::find_if(legal.moves.begin(), legal.moves.end(),
+                           [&](const Move& m) { return moveToString(m) == text; });
+    return it != legal.moves.end() ? *it : Move{};
+}
+
+int main() {
+    initEngineTables();
+
+    engineApiTests();
+    seeTests();
+    repetitionTests();
+    ttScoreTests();
+    transpositionTests();
+
+    if (failures) {
+        std::cerr << failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "All engine tests passed\n";
+    return 0;
+}
@@ -0,0 +1,24 @@
+// testing.h - Shared helpers of the checks built by "make engine_test", one group per file
+
+#pragma once
+#include "utils.h"
+#include "movegen.h"
+
+#include <string>
+
+/**
+ * check - Counts and reports a failed check, the run fails if any check did.
+ */
+void check(bool condition, const std::string& what);
+
+/**
+ * findMove - Legal move of @board in long algebraic notation ("e2e4"), a null move if there is none.
+ */
+Move findMove(const BoardState& board, const std::string& text);
+
+// Check groups, run by testMain.cpp
+void engineApiTests();
+void seeTests();
+void repetitionTests();
+void ttScoreTests();
+void transpositionTests();
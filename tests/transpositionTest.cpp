@@ -0,0 +1,46 @@
+// transpositionTest.cpp - TT entries are only returned for the key bits they were stored with
+
+#include "testing.h"
+#include "transposition.h"
+
+#include <cstdint>
+
+void transpositionTests() {
+    // 1 MB is 2^14 clusters, the cluster comes from the top 14 key bits: all keys below share one
+    TranspositionTable tt(1);
+    const uint64_t key = 0xABCDEF0012345678ULL;
+
+    TTEntry entry;
+    entry.key = key;
+    entry.depth = 9;
+    entry.score = -250;
+    entry.flag = LOWERBOUND;
+    entry.bestMove = Move{12, 28, '\0', false, false, false};
+    entry.eval = 37;
+    tt.store(entry);
+
+    TTEntry out;
+    bool hit = tt.probe(key, out);
+    check(hit, "TT: stored entry is found");
+    check(hit && out.depth == 9 && out.score == -250 && out.flag == LOWERBOUND && out.eval == 37 &&
+          out.bestMove.from == 12 && out.bestMove.to == 28, "TT: stored entry comes back whole");
+
+    // Other low 16 bits: the data word rejects the entry
+    check(!tt.probe(key ^ 0x0001, out), "TT: key differing in bit 0 misses");
+    check(!tt.probe(key ^ 0x8000, out), "TT: key differing in bit 15 misses");
+
+    // Bits 16..31 are only kept with the evaluation: the entry matches, its evaluation does not
+    hit = tt.probe(key ^ 0x10000, out);
+    check(hit && out.eval == TT_EVAL_NONE, "TT: key differing in bit 16 gets no evaluation");
+    hit = tt.probe(key ^ 0x80000000ULL, out);
+    check(hit && out.eval == TT_EVAL_NONE, "TT: key differing in bit 31 gets no evaluation");
+
+    // A second position in the same cluster takes another slot, both stay readable
+    TTEntry other = entry;
+    other.key = key ^ 0x0001;
+    other.score = 480;
+    other.eval = -12;
+    tt.store(other);
+    check(tt.probe(key, out) && out.score == -250 && out.eval == 37, "TT: first entry survives a neighbour");
+    check(tt.probe(key ^ 0x0001, out) && out.score == 480 && out.eval == -12, "TT: neighbour entry is found");
+}
@@ -0,0 +1,38 @@
+// ttScoreTest.cpp - Scores through the TT: mate distances move with the ply, the rest is kept
+
+#include "testing.h"
+#include "search.h"
+
+#include <string>
+
+void ttScoreTests() {
+    const int plies[] = {0, 1, 7, 40};
+
+    // Ordinary scores come back unchanged at any ply
+    for (int score : {0, 1, -1, 150, -3000, TT_MATE_BOUND - 1, -TT_MATE_BOUND + 1})
+        for (int stored : plies)
+            for (int read : plies)
+                check(scoreFromTT(scoreToTT(score, stored), read) == score,
+                      "TT score: " + std::to_string(score) + " stored at ply " + std::to_string(stored) +
+                      " read at ply " + std::to_string(read));
+
+    // A mate found at ply @stored, @toMate plies after that node, is as far from the node at any ply
+    for (int stored : plies) {
+        for (int toMate : {1, 5, 60}) {
+            for (int read : plies) {
+                int mating = MATE_SCORE - (stored + toMate);
+                int entry = scoreToTT(mating, stored);
+                std::string what = "mate in " + std::to_string(toMate) + " plies stored at ply " +
+                                   std::to_string(stored) + " read at ply " + std::to_string(read);
+                check(entry >= TT_MATE_BOUND && entry <= TT_SCORE_MAX, "TT score: " + what + " fits the entry");
+                check(scoreFromTT(entry, read) == MATE_SCORE - (read + toMate), "TT score: " + what);
+                check(scoreFromTT(scoreToTT(-mating, stored), read) == -MATE_SCORE + (read + toMate),
+                      "TT score: mated, " + what);
+            }
+        }
+    }
+
+    // Evaluations beyond the mate bound of the entry stay ordinary scores
+    check(scoreFromTT(scoreToTT(TT_MATE_BOUND + 500, 3), 3) == TT_MATE_BOUND - 1, "TT score: large score is clamped");
+    check(scoreFromTT(scoreToTT(-TT_MATE_BOUND - 500, 3), 3) == -TT_MATE_BOUND + 1, "TT score: large negative score is clamped");
+}